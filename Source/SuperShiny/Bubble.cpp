@@ -7,6 +7,9 @@
 #include "../ssge/Utilities.h"
 #include "SDL.h"
 
+// Sprite definition registered by SuperShiny::Sprites
+static const ClassID sprdefBubble("Bubble");
+
 void Bubble::pop()
 {
     popped = true;
@@ -57,14 +60,16 @@ Bubble::Bubble()
     hitbox.h = 16.f;
 }
 
-std::string Bubble::getEntityClassID() const
+const ClassID Bubble::classID("Bubble");
+
+ClassID Bubble::getEntityClassID() const
 {
-	return "Bubble";
+	return classID;
 }
 
 void Bubble::firstStep(EntityStepContext& context)
 {
-	sprite = context.sprites.create("Bubble");
+	sprite = context.sprites.create(sprdefBubble);
 }
 
 void Bubble::preStep(EntityStepContext& context)
@@ -115,8 +120,7 @@ void Bubble::postStep(EntityStepContext& context)
                         this->destroy();
                     }
 
-                    auto allCollisions = context.level.queryBlocksUnderCollider(collider);
-                    for (auto& collision : allCollisions)
+                    context.level.forEachBlockInRect(collider, [&](const Level::BlockVisit& collision)
                     {
                         auto* block = context.level.getBlockAt(collision.coords);
 
@@ -127,7 +131,7 @@ void Bubble::postStep(EntityStepContext& context)
                         case Collision::Hazard:
                             if (block)
                             {
-                                block->type = 0;
+                                context.level.setBlockType(collision.coords, 0);
                             }
                             [[fallthrough]];
                         case Collision::Solid:
@@ -139,35 +143,9 @@ void Bubble::postStep(EntityStepContext& context)
                             break;
                         }
 
-                        std::string callback = collision.callback;
-
                         // Handle blocks with Bubblable callback
-                        if (callback.substr(0, 9) == "Bubblable")
-                        {
-                            auto rightArrowIndex = callback.find('>');
-
-                            // Bubblable>x
-                            if (rightArrowIndex != std::string::npos)
-                            {
-                                std::size_t start = rightArrowIndex + 1;
-                                std::size_t end = callback.size();
-
-                                try
-                                {
-                                    std::string numberSubstring = callback.substr(start, end - start);
-                                    int newType = std::stoi(numberSubstring);
-                                    if (block)
-                                    { // Bubble the block
-                                        block->type = newType;
-                                    }
-                                }
-                                catch (...)
-                                {
-                                    // Ignore malformed number, do nothing
-                                }
-                            }
-                        }
-                    }
+                        callbacks().dispatch(*this, context, collision);
+                    });
                 }
 
                 if(poppedThisFrame)
@@ -184,6 +162,22 @@ void Bubble::postStep(EntityStepContext& context)
     animate();
 }
 
+const Bubble::Callbacks& Bubble::callbacks()
+{
+    static const Callbacks callbacks = Callbacks()
+        .on("Bubblable", &Bubble::onBubblable);
+    return callbacks;
+}
+
+// Callback: Bubblable>x
+void Bubble::onBubblable(EntityStepContext& context, const Level::BlockVisit& block)
+{
+    if (block.insideLevel && block.callback->has(Level::Block::Callback::Right))
+    { // Bubble the block
+        context.level.setBlockType(block.coords, block.callback->get(Level::Block::Callback::Right, 0));
+    }
+}
+
 void Bubble::preDraw(DrawContext& context) const
 {
 }
@@ -1,13 +1,18 @@
 #pragma once
 #include "../ssge/Entity.h"
+#include "../ssge/BlockCallbacks.h"
 
 using namespace ssge;
 
-class Bubble : public Entity
+class Bubble : public Entity, public Pooled<Bubble>
 {
 	bool popped = false;
 	void pop();
 	void animate();
+
+	using Callbacks = BlockCallbacks<Bubble, EntityStepContext>;
+	static const Callbacks& callbacks();
+	void onBubblable(EntityStepContext& context, const Level::BlockVisit& block);
 public:
 	enum class Sequences : int
 	{
@@ -15,9 +20,11 @@ public:
 		Popped = 1
 	};
 
+	static const ClassID classID;
+
 	Bubble();
 	// Inherited via Entity
-	std::string getEntityClassID() const override;
+	ClassID getEntityClassID() const override;
 	void firstStep(EntityStepContext& context) override;
 	void preStep(EntityStepContext& context) override;
 	void postStep(EntityStepContext& context) override;
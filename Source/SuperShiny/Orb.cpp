@@ -4,6 +4,9 @@
 #include <iostream>
 #include <memory>
 
+// Sprite definition registered by SuperShiny::Sprites
+static const ClassID sprdefOrb("Orb");
+
 Orb::Orb()
 {
     //sprite = std::make_unique<Sprite>(Game::Sprites::orb());
@@ -83,14 +86,16 @@ Orb::Orb()
     hitbox.h = 64;
 }
 
-std::string Orb::getEntityClassID() const
+const ClassID Orb::classID("Orb");
+
+ClassID Orb::getEntityClassID() const
 {
-    return "Orb";
+    return classID;
 }
 
 void Orb::firstStep(EntityStepContext& context)
 {
-    sprite = context.sprites.create("Orb");
+    sprite = context.sprites.create(sprdefOrb);
     //std::cout << "BORB!" << std::endl;
 }
 
@@ -114,16 +119,14 @@ void Orb::postStep(EntityStepContext& context)
                     hitbox.w + 2,
                     hitbox.h + 2
                 };
-                auto allCollisions = context.level.queryBlocksUnderCollider(collider);
-                for (auto& collision : allCollisions)
+                context.level.forEachBlockInRect(collider, [&](const Level::BlockVisit& collision)
                 {
-                    auto* block = context.level.getBlockAt(collision.coords);
                     if(collision.coll == Level::Block::Collision::Hazard)
                     {
                         shouldWeBounce = true;
-                        block->type = 0;
+                        context.level.setBlockType(collision.coords, 0);
                     }
-                }
+                });
             }
         }
     }
@@ -3,12 +3,14 @@
 
 using namespace ssge;
 
-class Orb : public Entity
+class Orb : public Entity, public Pooled<Orb>
 {
 public:
+	static const ClassID classID;
+
 	Orb();
 	// Inherited via Entity
-	std::string getEntityClassID() const override;
+	ClassID getEntityClassID() const override;
 	void firstStep(EntityStepContext& context) override;
 	void preStep(EntityStepContext& context) override;
 	void postStep(EntityStepContext& context) override;
@@ -5,8 +5,12 @@
 #include <memory>
 #include "../ssge/EntityManager.h"
 #include "../ssge/Utilities.h"
+#include "Bubble.h"
 #include "SDL.h"
 
+// Sprite definition registered by SuperShiny::Sprites
+static const ClassID sprdefShiny("Shiny");
+
 void Shiny::startBubbling()
 {
     if (!bubbling)
@@ -231,15 +235,17 @@ void Shiny::die()
     if (control)control->ignore();
 }
 
-std::string Shiny::getEntityClassID() const
+const ClassID Shiny::classID("Shiny");
+
+ClassID Shiny::getEntityClassID() const
 {
-	return "Shiny";
+	return classID;
 }
 
 void Shiny::firstStep(EntityStepContext& context)
 {
     // Create a sprite for Shiny
-    sprite = context.sprites.create("Shiny");
+    sprite = context.sprites.create(sprdefShiny);
 }
 
 void Shiny::preStep(EntityStepContext& context)
@@ -369,7 +375,7 @@ void Shiny::preStep(EntityStepContext& context)
                         bubbleTimer = bubbleDelay;
                         
                         // Create Bubble entity
-                        auto bubble = context.entities.addEntity("Bubble");
+                        auto bubble = context.entities.addEntity(Bubble::classID);
                         
                         // Place the bubble on Shiny's mouth
                         bubble->position.x = position.x + (7 * sign(sprite->xscale));
@@ -394,7 +400,7 @@ void Shiny::preStep(EntityStepContext& context)
         int tipOfTheHead = (int)(position.y + hitbox.y);
         if (tipOfTheHead >= levelBounds.h)
         {
-            context.gameWorld.reportHeroDeadth();
+            context.events.post(HeroDiedEvent{});
         }
     }
 }
@@ -426,11 +432,9 @@ void Shiny::postStep(EntityStepContext& context)
                     hitbox.w + (walkingLeft ? 1 : 0) + (walkingRight ? 1 : 0),
                     hitbox.h + (touchingCeiling ? 1 : 0) + (touchingGround ? 1 : 0)
                 };
-                auto allCollisions = context.level.queryBlocksUnderCollider(collider);
-                for (auto& collision : allCollisions)
+                context.level.forEachBlockInRect(collider, [&](const Level::BlockVisit& collision)
                 {
                     auto* block = context.level.getBlockAt(collision.coords);
-                    std::string callback = collision.callback;
 
                     // Collision with hazards
                     if (collision.coll == Level::Block::Collision::Hazard
@@ -467,97 +471,9 @@ void Shiny::postStep(EntityStepContext& context)
                         }
                     }
 
-                    // Handling blocks with Collectable callback
-                    if (callback == "Collectable")
-                    { // Leave empty
-                        block->type = 0;
-                    }
-
-                    // Callback: DestroyBlock>x,y<replaceCurrent
-                    if (callback.substr(0, 12) == "DestroyBlock")
-                    {
-                        auto rightArrowIndex = callback.find('>');
-                        auto commaIndex = callback.find(',');
-                        auto leftArrowIndex = callback.find('<');
-
-                        int destroyBlockX = -1;
-                        int destroyBlockY = -1;
-                        int replaceCurrentBlock = -1;
-
-                        if (rightArrowIndex != std::string::npos)
-                        {
-                            std::size_t start = rightArrowIndex + 1;
-                            std::size_t end = callback.size();
-
-                            // If there's also a ',' after '>', stop before it
-                            if (commaIndex != std::string::npos && commaIndex > rightArrowIndex)
-                            {
-                                end = commaIndex;
-                            }
-
-                            try
-                            {
-                                std::string numberSubstring = callback.substr(start, end - start);
-                                destroyBlockX = std::stoi(numberSubstring);
-                            }
-                            catch (...)
-                            {
-                                // Ignore malformed number, do nothing
-                            }
-                        }
-
-                        if (commaIndex != std::string::npos)
-                        {
-                            std::size_t start = commaIndex + 1;
-                            std::size_t end = callback.size();
-
-                            // If there's also a '<' after ',', stop before it
-                            if (leftArrowIndex != std::string::npos && leftArrowIndex > commaIndex)
-                            {
-                                end = leftArrowIndex;
-                            }
-
-                            try
-                            {
-                                std::string numberSubstring = callback.substr(start, end - start);
-                                destroyBlockY = std::stoi(numberSubstring);
-                            }
-                            catch (...)
-                            {
-                                // Ignore malformed number, do nothing
-                            }
-                        }
-
-                        if (leftArrowIndex != std::string::npos)
-                        {
-                            std::size_t start = leftArrowIndex + 1;
-                            std::size_t end = callback.size();
-
-                            try
-                            {
-                                std::string numberSubstring = callback.substr(start, end - start);
-                                replaceCurrentBlock = std::stoi(numberSubstring);
-                            }
-                            catch (...)
-                            {
-                                // Ignore malformed number, do nothing
-                            }
-                        }
-
-                        Level::Block::Coords destroyBlockCoords{destroyBlockX,destroyBlockY};
-                        Level::Block* destroyBlockPtr = context.level.getBlockAt(destroyBlockCoords);
-
-                        if(destroyBlockPtr) // Making sure the block is inside of the bounds
-                        {
-                            destroyBlockPtr->type = 0;
-                        }
-
-                        if(replaceCurrentBlock>=0) // Optional replacement of the current block
-                        {
-                            block->type = replaceCurrentBlock;
-                        }
-                    }
-                }
+                    // Collectables, switches and such
+                    bodyCallbacks().dispatch(*this, context, collision);
+                });
             }
             // Foot collisions
             {
@@ -567,102 +483,11 @@ void Shiny::postStep(EntityStepContext& context)
                     hitbox.w,
                     1
                 };
-                auto footCollisions = context.level.queryBlocksUnderCollider(footCollider);
-                for (auto& collision : footCollisions)
+                context.level.forEachBlockInRect(footCollider, [&](const Level::BlockVisit& collision)
                 {
-                    auto* block = context.level.getBlockAt(collision.coords);
-                    std::string callback = collision.callback;
-
-                    // Shiny can jump on blocks
-                    if (callback.substr(0, 3) == "Box")
-                    {
-                        // Stepping is not enough. Falling onto must be happening
-                        if (physics->oldVelocity.y > 0)
-                        {
-                            // Make Shiny jump
-                            physics->velocity.y = -physics->abilities.jumpSpeed;
-
-                            // Allow for holding the jump button to jump higher
-                            physics->jumpTimer = physics->abilities.jumpStrength;
-
-                            // Replace the box with what there is inside
-                            block->type = makeBoxNumber(collision.callback);
-                        }
-                    }
-
-                    // Shiny can terraform blocks he steps on
-
-                    if (callback.substr(0, 9) == "Terraform")
-                    {
-                        auto rightArrowIndex = callback.find('>');
-                        auto upArrowIndex = callback.find('^');
-                        auto dashIndex = callback.find('-');
-
-                        // Coordinates of the block under Shiny's clawbs
-                        auto colSpot = collision.coords;
-                        // Coordinates of the block above the block that's under Shiny's clawbs
-                        auto upperBlockCoords = Level::Block::Coords(
-                            colSpot.column,
-                            colSpot.row - 1
-                        );
-                        // Block that's above the block that's under Shiny's clawbs
-                        auto upperBlock = context.level.getBlockAt(upperBlockCoords);
-
-                        // Terraform current block (Terraform->X or Terraform^Y->X)
-                        if (rightArrowIndex != std::string::npos)
-                        {
-                            std::size_t start = rightArrowIndex + 1;
-                            std::size_t end = callback.size();
-
-                            // If there's also a '^' after '>', stop before it
-                            if (upArrowIndex != std::string::npos && upArrowIndex > rightArrowIndex)
-                            {
-                                end = upArrowIndex;
-                            }
-
-                            try
-                            {
-                                std::string numberSubstring = callback.substr(start, end - start);
-                                int newType = std::stoi(numberSubstring);
-                                if (block)
-                                { // Terraform!
-                                    block->type = newType;
-                                }
-                            }
-                            catch (...)
-                            {
-                                // Ignore malformed number, do nothing
-                            }
-                        }
-
-                        // Terraform upper block (Terraform^Y or Terraform->X^Y)
-                        if (upArrowIndex != std::string::npos)
-                        {
-                            std::size_t start = upArrowIndex + 1;
-                            std::size_t end = callback.size();
-
-                            // If there's also a '>' after '^', stop before it
-                            if (dashIndex != std::string::npos && dashIndex > upArrowIndex)
-                            {
-                                end = dashIndex;
-                            }
-
-                            try
-                            {
-                                std::string numberSubstring = callback.substr(start, end - start);
-                                int newType = std::stoi(numberSubstring);
-                                if (upperBlock)
-                                { // Terraform!
-                                    upperBlock->type = newType;
-                                }
-                            }
-                            catch (...)
-                            {
-                                // Ignore malformed number, do nothing
-                            }
-                        }
-                    }
-                }
+                    // Shiny can jump on boxes and terraform blocks he steps on
+                    footCallbacks().dispatch(*this, context, collision);
+                });
             }
             // Head collisions
             {
@@ -672,25 +497,11 @@ void Shiny::postStep(EntityStepContext& context)
                     hitbox.w,
                     1
                 };
-                auto headCollisions = context.level.queryBlocksUnderCollider(headCollider);
-                for (auto& collision : headCollisions)
+                context.level.forEachBlockInRect(headCollider, [&](const Level::BlockVisit& collision)
                 {
-                    auto* block = context.level.getBlockAt(collision.coords);
-
                     // Shiny can break blocks with his head
-                    if (collision.callback.substr(0, 3) == "Box")
-                    {
-                        // Only if actually going up, not scratching the box with his head
-                        if (physics->oldVelocity.y < 0)
-                        {
-                            // Headbonk
-                            physics->velocity.y = abs(physics->oldVelocity.y);
-
-                            // Replace the box with what there is inside
-                            block->type = makeBoxNumber(collision.callback);
-                        }
-                    }
-                }
+                    headCallbacks().dispatch(*this, context, collision);
+                });
             }
         }
     }
@@ -702,20 +513,109 @@ void Shiny::postStep(EntityStepContext& context)
     animate(context);
 }
 
-int Shiny::makeBoxNumber(std::string callback) const
+const Shiny::Callbacks& Shiny::bodyCallbacks()
 {
-    auto rightArrowIndex=callback.find('>');
+    static const Callbacks callbacks = Callbacks()
+        .on("Collectable", &Shiny::onCollectable)
+        .on("DestroyBlock", &Shiny::onDestroyBlock);
+    return callbacks;
+}
+
+const Shiny::Callbacks& Shiny::footCallbacks()
+{
+    static const Callbacks callbacks = Callbacks()
+        .on("Box", &Shiny::onBoxUnderfoot)
+        .on("Terraform", &Shiny::onTerraform);
+    return callbacks;
+}
+
+const Shiny::Callbacks& Shiny::headCallbacks()
+{
+    static const Callbacks callbacks = Callbacks()
+        .on("Box", &Shiny::onBoxOverhead);
+    return callbacks;
+}
+
+// Callback: Collectable
+void Shiny::onCollectable(EntityStepContext& context, const Level::BlockVisit& block)
+{
+    // Leave empty
+    context.level.setBlockType(block.coords, 0);
+}
 
-    try
+// Callback: DestroyBlock>x,y<replaceCurrent
+void Shiny::onDestroyBlock(EntityStepContext& context, const Level::BlockVisit& block)
+{
+    using Operand = Level::Block::Callback::Operand;
+    const auto& callback = *block.callback;
+
+    Level::Block::Coords destroyBlockCoords{
+        callback.get(Operand::Right, -1),
+        callback.get(Operand::Comma, -1)
+    };
+    int replaceCurrentBlock = callback.get(Operand::Left, -1);
+
+    if (context.level.getBlockAt(destroyBlockCoords)) // Making sure the block is inside of the bounds
     {
-        std::string numberString = callback.substr(rightArrowIndex + 1);
-        auto boxNumber = std::stoi(numberString);
-        return boxNumber;
+        context.level.setBlockType(destroyBlockCoords, 0);
     }
-    catch(...)
-    {// Bad index
-        // Default
-        return 0;
+
+    if (replaceCurrentBlock >= 0) // Optional replacement of the current block
+    {
+        context.level.setBlockType(block.coords, replaceCurrentBlock);
+    }
+}
+
+// Callback: Box>x (x is what's inside, empty if left out)
+void Shiny::onBoxUnderfoot(EntityStepContext& context, const Level::BlockVisit& block)
+{
+    // Stepping is not enough. Falling onto must be happening
+    if (physics->oldVelocity.y > 0)
+    {
+        // Make Shiny jump
+        physics->velocity.y = -physics->abilities.jumpSpeed;
+
+        // Allow for holding the jump button to jump higher
+        physics->jumpTimer = physics->abilities.jumpStrength;
+
+        // Replace the box with what there is inside
+        context.level.setBlockType(block.coords, block.callback->get(Level::Block::Callback::Right, 0));
+    }
+}
+
+void Shiny::onBoxOverhead(EntityStepContext& context, const Level::BlockVisit& block)
+{
+    // Only if actually going up, not scratching the box with his head
+    if (physics->oldVelocity.y < 0)
+    {
+        // Headbonk
+        physics->velocity.y = abs(physics->oldVelocity.y);
+
+        // Replace the box with what there is inside
+        context.level.setBlockType(block.coords, block.callback->get(Level::Block::Callback::Right, 0));
+    }
+}
+
+// Callback: Terraform->X, Terraform^Y or both
+void Shiny::onTerraform(EntityStepContext& context, const Level::BlockVisit& block)
+{
+    using Operand = Level::Block::Callback::Operand;
+    const auto& callback = *block.callback;
+
+    // Terraform the block under Shiny's clawbs
+    if (callback.has(Operand::Right) && block.insideLevel)
+    {
+        context.level.setBlockType(block.coords, callback.get(Operand::Right, 0));
+    }
+
+    // Terraform the block above it
+    auto upperBlockCoords = Level::Block::Coords(
+        block.coords.column,
+        block.coords.row - 1
+    );
+    if (callback.has(Operand::Up) && context.level.getBlockAt(upperBlockCoords))
+    {
+        context.level.setBlockType(upperBlockCoords, callback.get(Operand::Up, 0));
     }
 }
 
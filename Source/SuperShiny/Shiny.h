@@ -1,9 +1,10 @@
 #pragma once
 #include "../ssge/Entity.h"
+#include "../ssge/BlockCallbacks.h"
 
 using namespace ssge;
 
-class Shiny : public Entity
+class Shiny : public Entity, public Pooled<Shiny>
 {
     bool bubbleAux = false;
     float bubbleAuxOffset = -6;
@@ -20,6 +21,18 @@ class Shiny : public Entity
 	void quitBubbling();
 	void animate(EntityStepContext& context);
 
+	// Block callbacks, by how Shiny touches the block
+	using Callbacks = BlockCallbacks<Shiny, EntityStepContext>;
+	static const Callbacks& bodyCallbacks();
+	static const Callbacks& footCallbacks();
+	static const Callbacks& headCallbacks();
+
+	void onCollectable(EntityStepContext& context, const Level::BlockVisit& block);
+	void onDestroyBlock(EntityStepContext& context, const Level::BlockVisit& block);
+	void onBoxUnderfoot(EntityStepContext& context, const Level::BlockVisit& block);
+	void onBoxOverhead(EntityStepContext& context, const Level::BlockVisit& block);
+	void onTerraform(EntityStepContext& context, const Level::BlockVisit& block);
+
 public:
 
 	enum class Sequences : int
@@ -39,6 +52,8 @@ public:
 	Entity::Physics::Abilities makeRegularAbilities() const;
 	Entity::Physics::Abilities makeBubblingAbilities() const;
 
+	static const ClassID classID;
+
 	Shiny();
 
 	bool isDying() const;
@@ -46,11 +61,8 @@ public:
 	// Called when Shiny starts dying
 	void die();
 
-	// Helper function to read Box block callbacks
-	int makeBoxNumber(std::string callback) const;
-
 	// Inherited via Entity
-	std::string getEntityClassID() const override;
+	ClassID getEntityClassID() const override;
 	void firstStep(EntityStepContext& context) override;
 	void preStep(EntityStepContext& context) override;
 	void postStep(EntityStepContext& context) override;
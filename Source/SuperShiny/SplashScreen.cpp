@@ -3,12 +3,15 @@
 #include <memory>
 #include "../ssge/GameWorld.h"
 #include "../ssge/DrawContext.h"
+#include "TitleScreen.h"
 #include "../ssge/Scene.h"
 #include "SDL.h"
 
-std::string SplashScreen::getSceneClassID() const
+const ClassID SplashScreen::classID("SplashScreen");
+
+ClassID SplashScreen::getSceneClassID() const
 {
-	return "SplashScreen";
+	return classID;
 }
 
 SplashScreen::SplashScreen()
@@ -21,26 +24,24 @@ SplashScreen::~SplashScreen()
 
 void SplashScreen::init(SceneStepContext& context)
 {
-	background = SdlTexture("Backgrounds/Splash.png", context.drawing.getRenderer());
+	background = context.drawing.loadTexture("Backgrounds/Splash.png");
 }
 
 void SplashScreen::step(SceneStepContext& context)
 {
 	if (context.inputs.getCurrentButtonsForPlayer(0) != 0)
 	{
-		context.scenes.changeScene("TitleScreen");
+		context.scenes.changeScene(TitleScreen::classID);
 	}
 }
 
 void SplashScreen::draw(DrawContext& context)
 {
-	SDL_Renderer* renderer = context.getRenderer();
 	SDL_Rect screenRect = context.getBounds();
 
-	SDL_SetRenderDrawColor(renderer, 255, 255, 0, 255);
-	SDL_RenderFillRect(renderer, &screenRect);
+	context.fillRect(screenRect, SDL_Color{ 255, 255, 0, 255 });
 
 	if (background)
-		SDL_RenderCopy(renderer, background, nullptr, nullptr);
+		context.copy(background, nullptr, nullptr);
 
 }
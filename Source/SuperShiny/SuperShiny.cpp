@@ -8,6 +8,7 @@
 #include <vector>
 #include "SDL.h"
 #include "../ssge/InputSet.h"
+#include "../ssge/GameWorld.h"
 
 // GAMEDEV: Please include headers of your scenes
 #include "SplashScreen.h"
@@ -45,11 +46,23 @@ void SuperShiny::syncSettings(StepContext& context) const
 	context.audio.setSfxVolume(config.sfxVolume);
 }
 
-void SuperShiny::_queryQuit(StepContext& context)
+void SuperShiny::onSceneChanged(StepContext& context)
 {
-	std::string currentScene = context.scenes.getCurrentSceneClassID();
+	ClassID sceneID = context.scenes.getCurrentSceneClassID();
+
+	if (sceneID == scenes.getMainMenuSceneClassID())
+		currentScene = SceneKind::MainMenu;
+	else if (sceneID == GameWorld::classID)
+		currentScene = SceneKind::GameWorld;
+	else if (sceneID == VictoryScreen::classID)
+		currentScene = SceneKind::VictoryScreen;
+	else
+		currentScene = SceneKind::Other;
+}
 
-	if (currentScene != "GameWorld")
+void SuperShiny::onQuitRequested(StepContext& context)
+{
+	if (currentScene != SceneKind::GameWorld)
 	{
 		context.engine.wrapUp();
 		context.menus.close();
@@ -61,14 +74,46 @@ void SuperShiny::_queryQuit(StepContext& context)
 	}
 }
 
+void SuperShiny::onJoypadUnplugged(StepContext& context)
+{
+	// Only gameplay cares, menus work with whatever is still plugged in
+	if (currentScene == SceneKind::GameWorld)
+	{
+		context.scenes.pause(); // Pause the scene
+		// Open an abrupt menu for telling the user
+		// that a joypad got unplugged!
+		context.menus.abruptMenu(menus.joypadUnpluggedMenu);
+	}
+}
+
+void SuperShiny::onHeroDied(StepContext& context)
+{
+	// Try the level again
+	context.scenes.restart();
+}
+
+void SuperShiny::onVictory(StepContext& context)
+{
+	if (!processingGameVictory && currentScene != SceneKind::VictoryScreen)
+	{ // Start processing the game victory
+		// Pause game
+		context.scenes.pause();
+		// Queue VictoryScreen
+		context.scenes.changeScene(VictoryScreen::classID);
+		// Game victory processing begins now
+		processingGameVictory = true;
+		// It will end when the VictoryScreen shows up with its menus.
+	}
+}
+
 bool SuperShiny::init(StepContext& context)
 {
 	SDL_Renderer* renderer = context.drawing.getRenderer();
 
 	// Load sprites
-	sprites.load("Shiny", renderer);
-	sprites.load("Orb", renderer);
-	sprites.load("Bubble", renderer);
+	sprites.load(ClassID("Shiny"), renderer);
+	sprites.load(ClassID("Orb"), renderer);
+	sprites.load(ClassID("Bubble"), renderer);
 
 	// Set default inputs
 	auto& inputs = context.inputs;
@@ -90,8 +135,23 @@ bool SuperShiny::init(StepContext& context)
 	inputs.fetchBinding(9)->bindToKey(SDL_Scancode::SDL_SCANCODE_ESCAPE);
 	inputs.fetchFallbackBinding(9)->bindToKey(SDL_Scancode::SDL_SCANCODE_ESCAPE);
 
+	// Subscribe to engine events
+	auto& events = context.events;
+	events.subscribe<SceneChangedEvent>(
+		[this](const SceneChangedEvent&, StepContext& context) { onSceneChanged(context); });
+	events.subscribe<QuitRequestedEvent>(
+		[this](const QuitRequestedEvent&, StepContext& context) { onQuitRequested(context); });
+	events.subscribe<JoypadUnpluggedEvent>(
+		[this](const JoypadUnpluggedEvent&, StepContext& context) { onJoypadUnplugged(context); });
+	events.subscribe<HeroDiedEvent>(
+		[this](const HeroDiedEvent&, StepContext& context) { onHeroDied(context); });
+	events.subscribe<VictoryEvent>(
+		[this](const VictoryEvent&, StepContext& context) { onVictory(context); });
+	events.subscribe<SaveSettingsEvent>(
+		[this](const SaveSettingsEvent&, StepContext& context) { saveSettings(context); });
+
 	// Change scene
-	context.scenes.changeScene("SplashScreen");
+	context.scenes.changeScene(SplashScreen::classID);
 
 	// Load settings
 	IniFile configIni;
@@ -111,16 +171,8 @@ bool SuperShiny::init(StepContext& context)
 
 void SuperShiny::step(StepContext& context)
 {
-	if (queriedToQuit)
-	{ // Handle request to quit
-		_queryQuit(context);
-		queriedToQuit = false;
-	}
-
-	// What Scene are we on?
-	std::string currentScene = context.scenes.getCurrentSceneClassID();
-
-	if (currentScene == scenes.getMainMenuSceneClassID())
+	// What Scene are we on? (see onSceneChanged)
+	if (currentScene == SceneKind::MainMenu)
 	{ // Main menu scene
 
 		// Play title screen music
@@ -133,11 +185,8 @@ void SuperShiny::step(StepContext& context)
 		{
 			context.menus.setMenu(menus.mainMenu);
 		}
-
-		// Disregard unplugged joypads
-		_joypadGotUnplugged = false;
 	}
-	else if (currentScene == "GameWorld")
+	else if (currentScene == SceneKind::GameWorld)
 	{ // GameWorld
 
 		// Assess the current situation
@@ -178,18 +227,8 @@ void SuperShiny::step(StepContext& context)
 		{
 			context.scenes.pause();
 		}
-
-		// Pause on joypad disconnection!
-		if (_joypadGotUnplugged)
-		{
-			_joypadGotUnplugged = false;
-			context.scenes.pause(); // Pause the scene
-			// Open an abrupt menu for telling the user
-			// that a joypad got unplugged!
-			context.menus.abruptMenu(menus.joypadUnpluggedMenu);
-		}
 	}
-	else if (currentScene=="VictoryScreen")
+	else if (currentScene == SceneKind::VictoryScreen)
     { // Victory screen
 
 		// Show the victory menu and overlay it with a credits menu.
@@ -207,31 +246,6 @@ void SuperShiny::step(StepContext& context)
         }
     }
 
-	// Handle victory "event"
-	if (gameWasWon)
-    {
-        gameWasWon=false;
-        if(!processingGameVictory && currentScene != "VictoryScreen")
-        { // Start processing the game victory
-			 // Pause game
-            context.scenes.pause();
-			// Queue VictoryScreen
-			context.scenes.changeScene("VictoryScreen");
-			// Game victory processing begins now
-            processingGameVictory=true;
-			// It will end when the VictoryScreen shows up with its menus.
-        }
-    }
-
-	// Handle "event" for saving settings
-	if (wannaSaveSettings)
-	{
-		// Actually save the settings with the given context
-		saveSettings(context);
-		// "event" handled successfully
-		wannaSaveSettings = false;
-	}
-
 	// Handle graceful Engine shutdown
 	if (context.engine.isWrappingUp())
 	{
@@ -268,9 +282,9 @@ void SuperShiny::draw(DrawContext& context)
 void SuperShiny::cleanUp(PassKey<Engine> pk)
 {
 	// Unload all sprites
-	sprites.unload("Shiny");
-	sprites.unload("Orb");
-	sprites.unload("Bubble");
+	sprites.unload(ClassID("Shiny"));
+	sprites.unload(ClassID("Orb"));
+	sprites.unload(ClassID("Bubble"));
 }
 
 bool SuperShiny::saveSettings(StepContext& context)
@@ -294,26 +308,6 @@ bool SuperShiny::saveSettings(StepContext& context)
 	}
 }
 
-void SuperShiny::saveSettings()
-{ // Raise "event"
-	wannaSaveSettings = true;
-}
-
-void SuperShiny::declareVictory()
-{ // Raise "event"
-    gameWasWon = true;
-}
-
-void SuperShiny::queryQuit()
-{ // Raise "event"
-	queriedToQuit = true;
-}
-
-void SuperShiny::joypadGotUnplugged()
-{ // Raise "event"
-	_joypadGotUnplugged = true;
-}
-
 const char* SuperShiny::getApplicationTitle()
 { // GAMEDEV: Your caption here
 	return "Super Shiny";
@@ -334,14 +328,14 @@ MenuCommandEx SuperShiny::onHavingBackedOutOfMenus(PassKey<GameAccess> pk,
 {
 	MenuCommandEx cmdEx;
 
-	std::string currentScene = context.currentScene.getSceneClassID();
+	ClassID currentScene = context.currentScene.getSceneClassID();
 
 	if (currentScene==scenes.getMainMenuSceneClassID())
 	{ // If this is the main menu, ask the player do they wanna exit program
 		cmdEx.smallCmd = MenuCommand::SUB_MENU;
 		cmdEx.targetMenu = &menus.confirmExitProgram;
 	}
-	else if(currentScene=="VictoryScreen")
+	else if(currentScene==VictoryScreen::classID)
     {
         // IGNORE!!!
         cmdEx.smallCmd = MenuCommand::NOTHING;
@@ -371,23 +365,23 @@ IGameSprites& SuperShiny::getSprites()
 }
 
 std::unique_ptr<Scene> SuperShiny::Scenes::createScene(
-	PassKey<ScenesAccess> pk, std::string id)
+	PassKey<ScenesAccess> pk, ClassID id)
 { // GAMEDEV: Please register all your scenes here
-	if (id == "SplashScreen")
+	if (id == SplashScreen::classID)
 		return splashScreen();
 
-	else if (id == "TitleScreen")
+	else if (id == TitleScreen::classID)
 		return titleScreen();
 
-    else if (id == "VictoryScreen")
+    else if (id == VictoryScreen::classID)
         return victoryScreen();
 
 	else return nullptr;
 }
 
-std::string SuperShiny::Scenes::getMainMenuSceneClassID() const
+ClassID SuperShiny::Scenes::getMainMenuSceneClassID() const
 { // GAMEDEV: Your main menu scene class ID here
-	return "TitleScreen";
+	return TitleScreen::classID;
 }
 
 SuperShiny::Scenes::Scenes(PassKey<SuperShiny> pk) {}
@@ -411,37 +405,56 @@ std::unique_ptr<VictoryScreen> SuperShiny::Scenes::victoryScreen()
 
 // Simple Entity factory
 
-std::shared_ptr<Shiny> SuperShiny::Entities::shiny()
+std::unique_ptr<Shiny> SuperShiny::Entities::shiny()
 {
-	return std::make_shared<Shiny>();
+	return std::make_unique<Shiny>();
 }
 
-std::shared_ptr<Orb> SuperShiny::Entities::orb()
+std::unique_ptr<Orb> SuperShiny::Entities::orb()
 {
-	return std::make_shared<Orb>();
+	return std::make_unique<Orb>();
 }
 
-std::shared_ptr<Bubble> SuperShiny::Entities::bubble()
+std::unique_ptr<Bubble> SuperShiny::Entities::bubble()
 {
-	return std::make_shared<Bubble>();
+	return std::make_unique<Bubble>();
 }
 
 SuperShiny::Entities::Entities(PassKey<SuperShiny> pk) {}
 
-std::shared_ptr<Entity> SuperShiny::Entities::createEntity(PassKey<EntitiesAccess> pk, std::string entityId)
+std::unique_ptr<Entity> SuperShiny::Entities::createEntity(PassKey<EntitiesAccess> pk, ClassID entityId)
 {
-	if (entityId == "Shiny")
+	if (entityId == Shiny::classID)
 		return shiny();
 
-	else if (entityId == "Orb")
+	else if (entityId == Orb::classID)
 		return orb();
 
-	else if (entityId == "Bubble")
+	else if (entityId == Bubble::classID)
 		return bubble();
 
 	return nullptr;
 }
 
+size_t SuperShiny::Entities::reserveEntities(PassKey<EntitiesAccess> pk, ClassID entityId, size_t count)
+{ // GAMEDEV: Size your entity pools here (see Pooled)
+	if (entityId == Shiny::classID)
+	{
+		Shiny::reservePool(count);
+		// Shiny keeps shooting bubbles
+		Bubble::reservePool(count * BUBBLES_PER_SHINY);
+		return count + count * BUBBLES_PER_SHINY;
+	}
+
+	else if (entityId == Orb::classID)
+		Orb::reservePool(count);
+
+	else if (entityId == Bubble::classID)
+		Bubble::reservePool(count);
+
+	return count;
+}
+
 SuperShiny::Sprites::Sprites(PassKey<SuperShiny> pk)
 { // GAMEDEV: Define your sprites here
 	using Image = Sprite::Image;
@@ -558,9 +571,22 @@ SuperShiny::Sprites::Sprites(PassKey<SuperShiny> pk)
 		seq.imageIndexes.push_back(3);
 	}
 
+
+	// GAMEDEV: Register your sprite definitions here
+	registerDefinition(ClassID("Shiny"), sprdefShiny);
+	registerDefinition(ClassID("Orb"), sprdefOrb);
+	registerDefinition(ClassID("Bubble"), sprdefBubble);
+}
+
+void SuperShiny::Sprites::registerDefinition(ClassID sprdefId,
+	Sprite::Definition& sprdef)
+{
+	if (definitions.size() <= sprdefId.getIndex())
+		definitions.resize(sprdefId.getIndex() + 1, nullptr);
+	definitions[sprdefId.getIndex()] = &sprdef;
 }
 
-bool SuperShiny::Sprites::load(std::string sprdefId, SDL_Renderer* renderer)
+bool SuperShiny::Sprites::load(ClassID sprdefId, SDL_Renderer* renderer)
 {
 	Sprite::Definition* sprdef = fetchDefinitionNonConst(sprdefId);
 	if (sprdef)
@@ -568,7 +594,7 @@ bool SuperShiny::Sprites::load(std::string sprdefId, SDL_Renderer* renderer)
 	else return false;
 }
 
-void SuperShiny::Sprites::unload(std::string sprdefId)
+void SuperShiny::Sprites::unload(ClassID sprdefId)
 {
 	Sprite::Definition* sprdef = fetchDefinitionNonConst(sprdefId);
 	if (sprdef)
@@ -576,22 +602,16 @@ void SuperShiny::Sprites::unload(std::string sprdefId)
 }
 
 const Sprite::Definition* SuperShiny::Sprites::fetchDefinition(
-	const std::string& sprdefId)
+	ClassID sprdefId)
 {
 	return fetchDefinitionNonConst(sprdefId);
 }
 
 Sprite::Definition* SuperShiny::Sprites::fetchDefinitionNonConst(
-	const std::string& sprdefId)
-{ // GAMEDEV: Register your sprite definitions here
-	if (sprdefId == "Shiny")
-		return &sprdefShiny;
-
-	if (sprdefId == "Orb")
-		return &sprdefOrb;
-
-	if (sprdefId == "Bubble")
-		return &sprdefBubble;
+	ClassID sprdefId)
+{ // Registered in the constructor
+	if (sprdefId.getIndex() < definitions.size())
+		return definitions[sprdefId.getIndex()];
 
 	return nullptr;
 }
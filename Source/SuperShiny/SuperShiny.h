@@ -31,12 +31,25 @@ public:
 
 private:
     void syncSettings(StepContext& context) const;
-    bool wannaSaveSettings = false;
-    bool queriedToQuit = false;
-    bool gameWasWon = false;
     bool processingGameVictory = false;
 
-    void _queryQuit(StepContext& context);
+    // Which scene we're on. Updated on SceneChangedEvent, so step()
+    // doesn't have to compare scene IDs every tick.
+    enum class SceneKind
+    {
+        Other,
+        MainMenu,
+        GameWorld,
+        VictoryScreen
+    };
+    SceneKind currentScene = SceneKind::Other;
+
+    // Event handlers (subscribed in init)
+    void onSceneChanged(StepContext& context);
+    void onQuitRequested(StepContext& context);
+    void onJoypadUnplugged(StepContext& context);
+    void onHeroDied(StepContext& context);
+    void onVictory(StepContext& context);
 
 public: //TODO: Encapsulate
     // Called once after SDL + engine subsystems are up.
@@ -53,16 +66,6 @@ public: //TODO: Encapsulate
 
     bool saveSettings(StepContext& context) override;
 
-    // The game will save the settings later, don't worry
-    void saveSettings() override;
-
-    void queryQuit() override;
-
-    void declareVictory() override;
-
-    bool _joypadGotUnplugged = false;
-    void joypadGotUnplugged() override;
-
     // Get application title
     const char* getApplicationTitle() override;
 
@@ -88,8 +91,8 @@ public: //TODO: Encapsulate
         static std::unique_ptr<TitleScreen> titleScreen();
         static std::unique_ptr<VictoryScreen> victoryScreen();
 
-        std::unique_ptr<Scene> createScene(PassKey<ScenesAccess> pk, std::string id) override;
-        std::string getMainMenuSceneClassID() const override;
+        std::unique_ptr<Scene> createScene(PassKey<ScenesAccess> pk, ClassID id) override;
+        ClassID getMainMenuSceneClassID() const override;
     };
 
     Scenes scenes;
@@ -99,11 +102,14 @@ public: //TODO: Encapsulate
     class Entities : public IGameEntities
     {
         // GAMEDEV: Create methods that create your Entities
-        // Example: static std::shared_ptr<YourEntityClass> yourEntityClass();
+        // Example: static std::unique_ptr<YourEntityClass> yourEntityClass();
 
-        std::shared_ptr<Shiny> shiny();
-        std::shared_ptr<Orb> orb();
-        std::shared_ptr<Bubble> bubble();
+        std::unique_ptr<Shiny> shiny();
+        std::unique_ptr<Orb> orb();
+        std::unique_ptr<Bubble> bubble();
+
+        // A bubble every 10 ticks, each living up to 600
+        static const size_t BUBBLES_PER_SHINY = 60;
 
     public: //TODO: Encapsulate
         Entities(PassKey<SuperShiny> pk);
@@ -113,7 +119,8 @@ public: //TODO: Encapsulate
 
 
     public:
-        std::shared_ptr<Entity> createEntity(PassKey<EntitiesAccess> pk, std::string id) override;
+        std::unique_ptr<Entity> createEntity(PassKey<EntitiesAccess> pk, ClassID id) override;
+        size_t reserveEntities(PassKey<EntitiesAccess> pk, ClassID id, size_t count) override;
     };
 
     Entities entities;
@@ -126,17 +133,21 @@ public: //TODO: Encapsulate
         Sprite::Definition sprdefOrb;
         Sprite::Definition sprdefBubble;
 
+        // Definitions indexed by ClassID::getIndex()
+        std::vector<Sprite::Definition*> definitions;
+        void registerDefinition(ClassID sprdefId, Sprite::Definition& sprdef);
+
     public: //TODO: Encapsulate
         Sprites(PassKey<SuperShiny> pk);
         Sprites(const Sprites& toCopy) = delete;
         Sprites(Sprites&& toMove) = delete;
         ~Sprites() = default;
 
-        bool load(std::string sprdefId, SDL_Renderer* renderer) override;
-        void unload(std::string sprdefId) override;
-        const Sprite::Definition* fetchDefinition(const std::string& sprdefId) override;
+        bool load(ClassID sprdefId, SDL_Renderer* renderer) override;
+        void unload(ClassID sprdefId) override;
+        const Sprite::Definition* fetchDefinition(ClassID sprdefId) override;
     private:
-        Sprite::Definition* fetchDefinitionNonConst(const std::string& sprdefId);
+        Sprite::Definition* fetchDefinitionNonConst(ClassID sprdefId);
     };
 
     Sprites sprites;
@@ -6,9 +6,11 @@
 #include "../ssge/Scene.h"
 #include "SDL.h"
 
-std::string TitleScreen::getSceneClassID() const
+const ClassID TitleScreen::classID("TitleScreen");
+
+ClassID TitleScreen::getSceneClassID() const
 {
-	return "TitleScreen";
+	return classID;
 }
 
 TitleScreen::TitleScreen()
@@ -21,7 +23,7 @@ TitleScreen::~TitleScreen()
 
 void TitleScreen::init(SceneStepContext& context)
 {
-	background = SdlTexture("Backgrounds/ShinyRuns_XGA.png", context.drawing.getRenderer());
+	background = context.drawing.loadTexture("Backgrounds/ShinyRuns_XGA.png");
 }
 
 void TitleScreen::step(SceneStepContext& context)
@@ -30,13 +32,11 @@ void TitleScreen::step(SceneStepContext& context)
 
 void TitleScreen::draw(DrawContext& context)
 {
-	SDL_Renderer* renderer = context.getRenderer();
 	SDL_Rect screenRect = context.getBounds();
 
-	SDL_SetRenderDrawColor(renderer, 255, 255, 0, 255);
-	SDL_RenderFillRect(renderer, &screenRect);
+	context.fillRect(screenRect, SDL_Color{ 255, 255, 0, 255 });
 
 	if (background)
-		SDL_RenderCopy(renderer, background, nullptr, nullptr);
+		context.copy(background, nullptr, nullptr);
 
 }
@@ -6,9 +6,11 @@
 #include "../ssge/Scene.h"
 #include "SDL.h"
 
-std::string VictoryScreen::getSceneClassID() const
+const ClassID VictoryScreen::classID("VictoryScreen");
+
+ClassID VictoryScreen::getSceneClassID() const
 {
-	return "VictoryScreen";
+	return classID;
 }
 
 VictoryScreen::VictoryScreen()
@@ -21,7 +23,7 @@ VictoryScreen::~VictoryScreen()
 
 void VictoryScreen::init(SceneStepContext& context)
 {
-	background = SdlTexture("Backgrounds/Victory.png", context.drawing.getRenderer());
+	background = context.drawing.loadTexture("Backgrounds/Victory.png");
 	context.audio.playMusicIfNotPlaying("Music/Victory.ogg",1);
 }
 
@@ -35,13 +37,11 @@ void VictoryScreen::step(SceneStepContext& context)
 
 void VictoryScreen::draw(DrawContext& context)
 {
-	SDL_Renderer* renderer = context.getRenderer();
 	SDL_Rect screenRect = context.getBounds();
 
-	SDL_SetRenderDrawColor(renderer, 255, 255, 0, 255);
-	SDL_RenderFillRect(renderer, &screenRect);
+	context.fillRect(screenRect, SDL_Color{ 255, 255, 0, 255 });
 
 	if (background)
-		SDL_RenderCopy(renderer, background, nullptr, nullptr);
+		context.copy(background, nullptr, nullptr);
 
 }
@@ -9,11 +9,12 @@ class VictoryScreen : public Scene
 {
 	SdlTexture background;
 	// Inherited via Scene
-	std::string getSceneClassID() const override;
+	ClassID getSceneClassID() const override;
 	void init(SceneStepContext& context) override;
 	void step(SceneStepContext& context) override;
 	void draw(DrawContext& context) override;
 public:
+	static const ClassID classID;
 	VictoryScreen();
 	~VictoryScreen();
 };
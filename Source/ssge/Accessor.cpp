@@ -9,6 +9,7 @@
 #include "GameWorld.h"
 #include "EntityManager.h"
 #include "MenuSystem.h"
+#include "RenderGate.h"
 
 using namespace ssge;
 
@@ -34,7 +35,26 @@ bool EngineAccess::isWrappingUp() const
 	return actual->isWrappingUp();
 }
 
-void ScenesAccess::changeScene(std::string newSceneId)
+const EngineOptions& EngineAccess::getOptions() const
+{
+	return actual->getOptions();
+}
+
+JobPool* EngineAccess::getJobs() const
+{
+	if (!actual)return nullptr;
+
+	return actual->getJobs();
+}
+
+uint32_t EngineAccess::getRenderTargetResets() const
+{
+	if (!actual) return 0;
+
+	return actual->getRenderTargetResets();
+}
+
+void ScenesAccess::changeScene(ClassID newSceneId)
 {
 	if (actual)
 		actual->changeScene(
@@ -42,9 +62,9 @@ void ScenesAccess::changeScene(std::string newSceneId)
 		);
 }
 
-std::string ScenesAccess::getCurrentSceneClassID() const
+ClassID ScenesAccess::getCurrentSceneClassID() const
 {
-	if (!actual)return "";
+	if (!actual)return ClassID();
 
 	return actual->getCurrentSceneClassID();
 }
@@ -56,8 +76,8 @@ void ScenesAccess::goToLevel(int wantedLevel)
 
 void ScenesAccess::goToMainMenu()
 {
-	std::string mainMenuSceneClassID = gameScenes.getMainMenuSceneClassID();
-	if(!mainMenuSceneClassID.empty())
+	ClassID mainMenuSceneClassID = gameScenes.getMainMenuSceneClassID();
+	if(mainMenuSceneClassID)
 		changeScene(mainMenuSceneClassID);
 }
 
@@ -102,7 +122,7 @@ void ScenesAccess::restart()
 	if (!actual) return;
 
 	auto currentSceneClassID = actual->getCurrentSceneClassID();
-	if (currentSceneClassID == "GameWorld")
+	if (currentSceneClassID == GameWorld::classID)
 	{
 		// We need to get the wanted level if we want to restart the level
 
@@ -163,14 +183,22 @@ bool WindowAccess::isUpscaleIntegral() const
 
 void WindowAccess::setIntegralUpscale(bool integralUpscale)
 {
-	if (actual)
-		actual->setIntegralUpscale(integralUpscale);
+	if (!actual) return;
+
+	WindowManager* window = actual;
+	auto job = [=]() { window->setIntegralUpscale(integralUpscale); };
+	if (gate) gate->invoke(job);
+	else job();
 }
 
 void WindowAccess::setBorderedFullScreen(bool borderedFullScreen)
 {
-	if (actual)
-		actual->setBorderedFullScreen(borderedFullScreen);
+	if (!actual) return;
+
+	WindowManager* window = actual;
+	auto job = [=]() { window->setBorderedFullScreen(borderedFullScreen); };
+	if (gate) gate->invoke(job);
+	else job();
 }
 
 SDL_Rect WindowAccess::makeBestFitScale() const
@@ -389,9 +417,9 @@ void InputsAccessConfigurable::saveToIniFile(IniFile& iniFile)
 
 // CurrentSceneAccess
 
-std::string CurrentSceneAccess::getSceneClassID() const
+ClassID CurrentSceneAccess::getSceneClassID() const
 {
-	if (!currentScene)return "";
+	if (!currentScene)return ClassID();
 
 	return currentScene->getSceneClassID();
 }
@@ -472,6 +500,20 @@ std::vector<Level::BlockQuery> LevelAccess::queryBlocksUnderCollider(
 	return actual->queryBlocksUnderCollider(collider);
 }
 
+Level::Block::Collision LevelAccess::getCollision(int col, int row) const
+{
+	if (!actual)return Level::Block::Collision::Air;
+
+	return actual->getCollision(col, row);
+}
+
+Level::Block::Collision LevelAccess::getCollision(SDL_FPoint positionInLevel) const
+{
+	if (!actual)return Level::Block::Collision::Air;
+
+	return actual->getCollision(positionInLevel);
+}
+
 Level::SweepHit LevelAccess::sweepHorizontal(
 	const SDL_FRect& rect,
 	float dx) const
@@ -497,9 +539,39 @@ bool LevelAccess::rectInWater(const SDL_FRect& r) const
 	return actual->rectInWater(r);
 }
 
+bool LevelAccess::rectInSolid(const SDL_FRect& r) const
+{
+	if (!actual)return false;
+
+	return actual->rectInSolid(r);
+}
+
+bool LevelAccess::setBlockType(Level::Block::Coords coords, int type)
+{
+	if (!actual)return false;
+
+	if (journal)
+	{
+		if (!actual->getConstBlockAt(coords))
+			return false;
+		journal->record(coords, type);
+		return true;
+	}
+
+	return actual->setBlockType(coords, type);
+}
+
+void LevelAccess::applyJournals(PassKey<EntityManager> pk, const std::vector<Level::WriteJournal>& journals,
+	std::vector<Level::WriteJournal::Write>& merged)
+{
+	if (!actual)return;
+
+	actual->applyJournals(journals, merged);
+}
+
 // EntitiesAccess
 
-EntityReference EntitiesAccess::addEntity(std::string entityID)
+EntityReference EntitiesAccess::addEntity(ClassID entityID)
 {
 	if (!actual) return EntityReference();
 
@@ -508,14 +580,43 @@ EntityReference EntitiesAccess::addEntity(std::string entityID)
 	);
 }
 
+size_t EntitiesAccess::reserveEntities(ClassID entityID, size_t count)
+{
+	return gameEntities.reserveEntities(PassKey<EntitiesAccess>(), entityID, count);
+}
+
+const EntityQueryResult& EntitiesAccess::queryRect(const SDL_FRect& rect)
+{
+	static const EntityQueryResult none;
+	if (!actual) return none;
+
+	return actual->queryRect(rect);
+}
+
+const EntityQueryResult& EntitiesAccess::queryRadius(SDL_FPoint center, float radius)
+{
+	static const EntityQueryResult none;
+	if (!actual) return none;
+
+	return actual->queryRadius(center, radius);
+}
+
+const std::vector<EntityPair>& EntitiesAccess::queryPairs()
+{
+	static const std::vector<EntityPair> none;
+	if (!actual) return none;
+
+	return actual->queryPairs();
+}
+
 // SpritesAccess
 
-const Sprite::Definition* SpritesAccess::fetchDefinition(std::string sprdefId)
+const Sprite::Definition* SpritesAccess::fetchDefinition(ClassID sprdefId)
 {
 	return actual.fetchDefinition(sprdefId);
 }
 
-std::unique_ptr<Sprite> SpritesAccess::create(std::string sprdefId)
+std::unique_ptr<Sprite> SpritesAccess::create(ClassID sprdefId)
 {
 	auto sprdef = fetchDefinition(sprdefId);
 	if (sprdef)
@@ -574,25 +675,22 @@ void MenusAccess::close()
 	actual->close();
 }
 
-// GameWorldAccess
-
-void GameWorldAccess::reportHeroDeadth()
-{
-	if (currentGameWorld)
-		currentGameWorld->reportHeroDeadth();
-}
-
 MenuCommandEx GameAccess::onHavingBackedOutOfMenus(PassKey<MenuManager> pk, MenuContext& context)
 {
 	return actual.onHavingBackedOutOfMenus(PassKey<GameAccess>(), context);
 }
 
-void GameAccess::saveSettings()
+void DrawingAccess::onRenderThread(const std::function<void()>& job) const
 {
-	actual.saveSettings();
+	if (gate) gate->invoke(job);
+	else if (job) job();
 }
 
-void GameAccess::declareVictory()
+SdlTexture DrawingAccess::loadTexture(const std::string& path) const
 {
-    actual.declareVictory();
+	SdlTexture texture;
+	if (!renderer) return texture;
+
+	onRenderThread([&]() { texture = SdlTexture(path, renderer); });
+	return texture;
 }
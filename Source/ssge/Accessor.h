@@ -2,10 +2,13 @@
 #include "PassKey.h"
 #include <SDL.h>
 #include <memory>
+#include <functional>
 #include "Level.h"
+#include "SdlTexture.h"
 #include "IGame.h"
 #include "InputBinding.h"
 #include "InputSet.h"
+#include "EventBus.h"
 
 namespace ssge {
 
@@ -17,6 +20,8 @@ namespace ssge {
     class EntityManager;
     class Entity;
     class EntityReference;
+    class EntityQueryResult;
+    struct EntityPair;
     class InputManager;
     class Scene;
     class GameWorld;
@@ -24,8 +29,11 @@ namespace ssge {
     class MenuCommandEx;
     class MenuContext;
     class MenuHeader;
+    class RenderGate;
 
     class EngineAccessRestrained;
+    class JobPool;
+    struct EngineOptions;
 
     class EngineAccess {
     protected:
@@ -36,6 +44,11 @@ namespace ssge {
         void finish();
         void wrapUp();
         bool isWrappingUp() const;
+        const EngineOptions& getOptions() const;
+        // The engine's worker threads (one, the caller, when running serially)
+        JobPool* getJobs() const;
+        // Changes whenever render target contents were lost (device reset)
+        uint32_t getRenderTargetResets() const;
     };
 
     class EngineAccessRestrained : public EngineAccess
@@ -53,8 +66,6 @@ namespace ssge {
         explicit GameAccess(IGame& actual) : actual(actual) {}
         IGame& get() { return actual; }
         MenuCommandEx onHavingBackedOutOfMenus(PassKey<MenuManager> pk, MenuContext& context);
-        void declareVictory();
-        void saveSettings();
     };
 
     class ScenesAccess {
@@ -63,8 +74,8 @@ namespace ssge {
     public:
         explicit ScenesAccess(SceneManager* actual, IGame& game)
             : actual(actual), gameScenes(game.getScenes(PassKey<ScenesAccess>())) { }
-        void changeScene(std::string newSceneId);
-        std::string getCurrentSceneClassID() const;
+        void changeScene(ClassID newSceneId);
+        ClassID getCurrentSceneClassID() const;
         void goToLevel(int wantedLevel);
         void goToMainMenu();
         void pause();
@@ -79,9 +90,10 @@ namespace ssge {
 
     class WindowAccess {
         WindowManager* actual;
+        RenderGate* gate; // Window changes happen on the render thread
     public:
-        explicit WindowAccess(WindowManager* actual)
-            : actual(actual) {}
+        explicit WindowAccess(WindowManager* actual, RenderGate* gate = nullptr)
+            : actual(actual), gate(gate) {}
         // Gets the window
         SDL_Window* getWindow() const;
         // Gets the window surface
@@ -154,9 +166,16 @@ namespace ssge {
 
     class DrawingAccess {
         SDL_Renderer* renderer;
+        RenderGate* gate; // Renderer work happens on the render thread
     public:
-        explicit DrawingAccess(SDL_Renderer* renderer) : renderer(renderer) {}
+        explicit DrawingAccess(SDL_Renderer* renderer, RenderGate* gate = nullptr)
+            : renderer(renderer), gate(gate) {}
         SDL_Renderer* getRenderer() const { return renderer; }
+        // Runs renderer work (e.g. texture loading) on the render thread
+        // and waits for it. Runs right away if rendering isn't threaded.
+        void onRenderThread(const std::function<void()>& job) const;
+        // Loads a texture from a file on the render thread
+        SdlTexture loadTexture(const std::string& path) const;
         void fillRect(const SDL_Rect& rect, SDL_Color color) const {
             if (!renderer) return;
             SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
@@ -169,22 +188,34 @@ namespace ssge {
         Scene* currentScene;
     public:
         explicit CurrentSceneAccess(Scene* current) : currentScene(current) {}
-        std::string getSceneClassID() const;
+        ClassID getSceneClassID() const;
     };
 
     class GameWorldAccess {
         GameWorld* currentGameWorld;
     public:
         explicit GameWorldAccess(GameWorld* current) : currentGameWorld(current) {}
-        void reportHeroDeadth();
         //TBA
     };
 
     class LevelAccess {
         Level* actual;
+        Level::WriteJournal* journal = nullptr; // Holds back writes while set
     public:
         explicit LevelAccess(Level* actual) : actual(actual) {}
 
+        // EntityManager routes block writes of its second step halves
+        // into per-worker journals
+        void setJournal(PassKey<EntityManager> pk, Level::WriteJournal* journal) { this->journal = journal; }
+        void applyJournals(PassKey<EntityManager> pk, const std::vector<Level::WriteJournal>& journals,
+            std::vector<Level::WriteJournal::Write>& merged);
+
+        // Changes a block's type. During the second halves of entity steps
+        // (postStep) this is recorded and applied after every entity is
+        // done, so write blocks through here rather than through Block*.
+        // False if coords are out of bounds.
+        bool setBlockType(Level::Block::Coords coords, int type);
+
         bool valid() const;
 
         // Return tile indices overlapped by a rect (clamped to level bounds).
@@ -209,6 +240,20 @@ namespace ssge {
         // Queries all blocks that overlap the specified collider
         std::vector<Level::BlockQuery> queryBlocksUnderCollider(SDL_FRect collider) const;
 
+        // Collision of a block (with OOB policy), without building a query
+        Level::Block::Collision getCollision(int col, int row) const;
+        Level::Block::Collision getCollision(SDL_FPoint positionInLevel) const;
+
+        // Calls visit(const Level::BlockVisit&) for every block that
+        // overlaps rect. Doesn't allocate, unlike queryBlocksUnderCollider.
+        // A visitor returning bool can stop early by returning false.
+        template<typename Visitor>
+        void forEachBlockInRect(const SDL_FRect& rect, Visitor&& visit) const
+        {
+            if (!actual) return;
+            actual->forEachBlockInRect(rect, std::forward<Visitor>(visit));
+        }
+
         // Axis-separated sweep: move horizontally by dx, collide with solids.
         Level::SweepHit sweepHorizontal(const SDL_FRect& rect, float dx) const;
 
@@ -217,6 +262,37 @@ namespace ssge {
 
         // Is any overlapped tile "water"?
         bool rectInWater(const SDL_FRect& r) const;
+
+        // Is any overlapped tile solid?
+        bool rectInSolid(const SDL_FRect& r) const;
+
+        // The same for physics, in PhysicsReal (float or Fixed)
+
+        template<typename Real>
+        Level::BasicSweepHit<Real> sweepHorizontal(const Level::Box<Real>& rect, Real dx) const
+        {
+            if (!actual) return Level::BasicSweepHit<Real>();
+            return actual->sweepHorizontal(rect, dx);
+        }
+
+        template<typename Real>
+        Level::BasicSweepHit<Real> sweepVertical(const Level::Box<Real>& rect, Real dy) const
+        {
+            if (!actual) return Level::BasicSweepHit<Real>();
+            return actual->sweepVertical(rect, dy);
+        }
+
+        template<typename Real>
+        bool rectInWater(const Level::Box<Real>& r) const
+        {
+            return actual && actual->rectInWater(r);
+        }
+
+        template<typename Real>
+        bool rectInSolid(const Level::Box<Real>& r) const
+        {
+            return actual && actual->rectInSolid(r);
+        }
     };
 
     class EntitiesAccess {
@@ -227,22 +303,49 @@ namespace ssge {
             : actual(actual), gameEntities(game.get().getEntities(PassKey<EntitiesAccess>())) { }
         //TBA
         //TODO: Spawning in new entities, entity lookup, etc.
-        EntityReference addEntity(std::string entityID);
+        EntityReference addEntity(ClassID entityID);
+        // Lets the game size its pools, returns how many entities it expects
+        size_t reserveEntities(ClassID entityID, size_t count);
+        // Entities whose hitbox overlaps rect. The result is reused by
+        // the next query, so don't query again while walking it.
+        const EntityQueryResult& queryRect(const SDL_FRect& rect);
+        // Entities whose hitbox is within radius of center (same caveat)
+        const EntityQueryResult& queryRadius(SDL_FPoint center, float radius);
+        // Every pair of entities with overlapping hitboxes, each pair once
+        const std::vector<EntityPair>& queryPairs();
     };
 
     class EntitiesAccessWCurrent : public EntitiesAccess {
+        Entity* current;
     public:
-        Entity& current;
-        explicit EntitiesAccessWCurrent(EntityManager* actual, GameAccess& game, Entity* current)
-            : EntitiesAccess(actual, game), current(*current) {}
+        explicit EntitiesAccessWCurrent(EntityManager* actual, GameAccess& game, Entity* current = nullptr)
+            : EntitiesAccess(actual, game), current(current) {}
+        // The entity being stepped
+        Entity& getCurrent() const { return *current; }
+        // EntityManager moves one context along from entity to entity
+        void rebind(PassKey<EntityManager> pk, Entity* current) { this->current = current; }
     };
 
     class SpritesAccess {
         IGameSprites& actual;
     public:
         explicit SpritesAccess(IGameSprites& actual) : actual(actual) {}
-        const Sprite::Definition* fetchDefinition(std::string sprdefId);
-        std::unique_ptr<Sprite> create(std::string sprdefId);
+        const Sprite::Definition* fetchDefinition(ClassID sprdefId);
+        std::unique_ptr<Sprite> create(ClassID sprdefId);
+    };
+
+    class EventsAccess {
+        EventBus* actual;
+    public:
+        explicit EventsAccess(EventBus* actual) : actual(actual) {}
+        // Queues an event. It's delivered at the Engine's next drain point.
+        template<typename T>
+        bool post(const T& event) { return actual ? actual->post(event) : false; }
+        // Calls handler for every delivered event of type T
+        template<typename T>
+        void subscribe(EventBus::Handler<T> handler) {
+            if (actual) actual->subscribe<T>(std::move(handler));
+        }
     };
 
     class MenusAccess {
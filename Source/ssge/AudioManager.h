@@ -4,6 +4,7 @@
 #include <SDL.h>
 #include <SDL_mixer.h>
 #include "PassKey.h"
+#include "Profiler.h"
 
 namespace ssge
 {
@@ -13,6 +14,10 @@ namespace ssge
         int musicVol = 100; // 0..100
         int sfxVol = 100; // 0..100
 
+        // False until init() opens the device. Without it (headless runs,
+        // no sound card) every call below is a silent no-op.
+        bool opened = false;
+
         Mix_Music* currentMusic = nullptr;
         std::string currentMusicPath;
 
@@ -28,6 +33,8 @@ namespace ssge
         }
         void applyVolumes()
         {
+            if (!opened) return;
+
             // music volume = master * music
             int m = (toSDL(masterVol) * musicVol) / 100;
             Mix_VolumeMusic(m);
@@ -63,19 +70,24 @@ namespace ssge
             }
             // A few channels for SFX
             Mix_AllocateChannels(16);
+            opened = true;
             applyVolumes();
             return true;
         }
 
         void shutdown()
         {
-            Mix_HaltChannel(-1);
-            Mix_HaltMusic();
-            for (auto& kv : chunks) Mix_FreeChunk(kv.second);
-            chunks.clear();
-            for (auto& kv : musics) Mix_FreeMusic(kv.second);
-            musics.clear();
-            Mix_CloseAudio();
+            if (opened)
+            {
+                Mix_HaltChannel(-1);
+                Mix_HaltMusic();
+                for (auto& kv : chunks) Mix_FreeChunk(kv.second);
+                chunks.clear();
+                for (auto& kv : musics) Mix_FreeMusic(kv.second);
+                musics.clear();
+                Mix_CloseAudio();
+                opened = false;
+            }
             Mix_Quit();
         }
 
@@ -90,6 +102,8 @@ namespace ssge
         // Music
         bool playMusic(const std::string& path, int loops = -1)
         {
+            SSGE_PROFILE_ZONE("AudioManager::playMusic");
+            if (!opened) return false;
             Mix_Music* m = nullptr;
             auto it = musics.find(path);
             if (it == musics.end())
@@ -116,13 +130,15 @@ namespace ssge
             }
             return true;
         }
-        void stopMusic() { Mix_HaltMusic(); }
-        void pauseMusic() { Mix_PauseMusic(); }
-        void resumeMusic() { Mix_ResumeMusic(); }
+        void stopMusic() { if (opened) Mix_HaltMusic(); }
+        void pauseMusic() { if (opened) Mix_PauseMusic(); }
+        void resumeMusic() { if (opened) Mix_ResumeMusic(); }
 
         // SFX
         bool loadSfx(const std::string& path)
         {
+            SSGE_PROFILE_ZONE("AudioManager::loadSfx");
+            if (!opened) return false;
             if (chunks.count(path)) return true;
             Mix_Chunk* c = Mix_LoadWAV(path.c_str());
             if (!c)
@@ -147,6 +163,7 @@ namespace ssge
         // Is anything currently playing (not paused)?
         bool isMusicPlaying() const
         {
+            if (!opened) return false;
             return Mix_PlayingMusic() == 1 && Mix_PausedMusic() == 0;
         }
 
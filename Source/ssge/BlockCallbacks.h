@@ -0,0 +1,48 @@
+#pragma once
+#include <vector>
+#include "ClassID.h"
+#include "Level.h"
+
+namespace ssge
+{
+	// Handlers for compiled block callbacks, one per opcode.
+	//
+	// Game code fills a table once (a function-local static does) with
+	// member functions of Owner, then dispatches every touched block
+	// through it. Looking a handler up is an index into a vector: no
+	// strings are compared or parsed while stepping.
+	//
+	// Keep one table per way of touching blocks. Shiny's feet and head
+	// both react to "Box", but differently.
+	template<typename Owner, typename Context>
+	class BlockCallbacks
+	{
+	public:
+		using Handler = void (Owner::*)(Context& context, const Level::BlockVisit& block);
+
+	private:
+		std::vector<Handler> handlers; // By opcode index, null = unhandled
+
+	public:
+		// Hooks handler to the callbacks named opcode
+		BlockCallbacks& on(const char* opcode, Handler handler)
+		{
+			uint32_t index = ClassID(opcode).getIndex();
+			if (index >= handlers.size())
+				handlers.resize(index + 1, nullptr);
+			handlers[index] = handler;
+			return *this;
+		}
+
+		// Runs owner's handler for the block's callback.
+		// False if the block has none or nobody hooked its opcode.
+		bool dispatch(Owner& owner, Context& context, const Level::BlockVisit& block) const
+		{
+			uint32_t index = block.callback->opcode.getIndex();
+			if (index == 0 || index >= handlers.size() || !handlers[index])
+				return false;
+			(owner.*handlers[index])(context, block);
+			return true;
+		}
+	};
+}
@@ -0,0 +1,89 @@
+#include "ClassID.h"
+#include <SDL.h>
+#include <deque>
+#include <unordered_map>
+
+using namespace ssge;
+
+namespace
+{
+	// Function-local so static ClassIDs in other files can intern safely
+	// during static initialization
+	struct Registry
+	{
+		SDL_SpinLock lock = 0;
+		std::deque<std::string> names{ std::string() }; // Stable references
+		std::unordered_map<std::string, uint32_t> indexes;
+	};
+
+	Registry& registry()
+	{
+		static Registry instance;
+		return instance;
+	}
+
+	uint32_t intern(const std::string& name)
+	{
+		if (name.empty())
+			return 0;
+
+		Registry& reg = registry();
+		SDL_AtomicLock(&reg.lock);
+
+		uint32_t index;
+		auto it = reg.indexes.find(name);
+		if (it != reg.indexes.end())
+		{
+			index = it->second;
+		}
+		else
+		{
+			index = (uint32_t)reg.names.size();
+			reg.names.push_back(name);
+			reg.indexes.emplace(name, index);
+		}
+
+		SDL_AtomicUnlock(&reg.lock);
+		return index;
+	}
+}
+
+ClassID::ClassID(const char* name) :
+	index(name ? intern(name) : 0)
+{
+}
+
+ClassID::ClassID(const std::string& name) :
+	index(intern(name))
+{
+}
+
+ClassID ClassID::find(const std::string& name)
+{
+	Registry& reg = registry();
+	SDL_AtomicLock(&reg.lock);
+
+	auto it = reg.indexes.find(name);
+	uint32_t index = it != reg.indexes.end() ? it->second : 0;
+
+	SDL_AtomicUnlock(&reg.lock);
+	return ClassID(index);
+}
+
+uint32_t ClassID::count()
+{
+	Registry& reg = registry();
+	SDL_AtomicLock(&reg.lock);
+	uint32_t count = (uint32_t)reg.names.size() - 1;
+	SDL_AtomicUnlock(&reg.lock);
+	return count;
+}
+
+const std::string& ClassID::getName() const
+{
+	Registry& reg = registry();
+	SDL_AtomicLock(&reg.lock);
+	const std::string& name = reg.names[index];
+	SDL_AtomicUnlock(&reg.lock);
+	return name;
+}
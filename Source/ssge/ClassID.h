@@ -0,0 +1,47 @@
+#pragma once
+#include <cstdint>
+#include <string>
+
+namespace ssge
+{
+	// Interned name of a scene, entity or sprite definition class (or of a
+	// block callback opcode).
+	//
+	// Constructing one from a name looks it up in a global registry (and
+	// registers it the first time), so do that once: keep IDs in static
+	// constants or convert level file names while loading. After that,
+	// comparing IDs is an integer compare and getIndex() can index tables.
+	// The name stays around for logging and for writing things back out.
+	//
+	// The same name always gives the same ID for the lifetime of the program.
+	class ClassID
+	{
+		uint32_t index = 0; // 0 = none
+
+		explicit ClassID(uint32_t index) : index(index) {}
+
+	public:
+		// No class
+		ClassID() = default;
+		// Interns name (an empty name is "no class")
+		explicit ClassID(const char* name);
+		explicit ClassID(const std::string& name);
+
+		// Looks up an already interned name without registering it
+		static ClassID find(const std::string& name);
+
+		// How many IDs have been interned (indexes are 1..count)
+		static uint32_t count();
+
+		// Small and dense, good for indexing lookup tables
+		uint32_t getIndex() const { return index; }
+
+		// The interned name ("" for no class). Not meant for hot paths.
+		const std::string& getName() const;
+
+		explicit operator bool() const { return index != 0; }
+		bool operator==(const ClassID& other) const { return index == other.index; }
+		bool operator!=(const ClassID& other) const { return index != other.index; }
+		bool operator<(const ClassID& other) const { return index < other.index; }
+	};
+}
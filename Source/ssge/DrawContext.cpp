@@ -1,4 +1,5 @@
 #include "DrawContext.h"
+#include "FramePacket.h"
 
 using namespace ssge;
 
@@ -54,7 +55,9 @@ DrawContext::DrawContext(const DrawContext& toCopy)
 	deltaTime(toCopy.deltaTime),
 	scrollOffset(toCopy.scrollOffset),
 	renderTarget(toCopy.renderTarget),
-	font(toCopy.font)
+	font(toCopy.font),
+	interpolation(toCopy.interpolation),
+	packet(toCopy.packet)
 { }
 
 SDL_Renderer* DrawContext::getRenderer() const
@@ -95,6 +98,19 @@ TTF_Font* ssge::DrawContext::getFont()
 	return font;
 }
 
+float DrawContext::getInterpolation() const
+{
+	return interpolation;
+}
+
+SDL_FPoint DrawContext::interpolate(SDL_FPoint previous, SDL_FPoint current) const
+{
+	return SDL_FPoint{
+		previous.x + (current.x - previous.x) * interpolation,
+		previous.y + (current.y - previous.y) * interpolation
+	};
+}
+
 DrawContext DrawContext::clone() const
 {
 	return DrawContext(*this);
@@ -127,6 +143,118 @@ DrawContext ssge::DrawContext::deriveWithFont(TTF_Font* font) const
 	return derivedContext;
 }
 
+DrawContext DrawContext::deriveWithInterpolation(float interpolation) const
+{
+	DrawContext derivedContext = DrawContext(*this);
+
+	if (interpolation < 0.0f) interpolation = 0.0f;
+	if (interpolation > 1.0f) interpolation = 1.0f;
+	derivedContext.interpolation = interpolation;
+
+	return derivedContext;
+}
+
+DrawContext DrawContext::deriveForRecording(FramePacket* packet) const
+{
+	DrawContext derivedContext = DrawContext(*this);
+
+	derivedContext.packet = packet;
+
+	return derivedContext;
+}
+
+bool DrawContext::isRecording() const
+{
+	return packet != nullptr;
+}
+
+void DrawContext::fillRect(const SDL_Rect& rect, SDL_Color color) const
+{
+	if (packet)
+	{
+		packet->fillRect(rect, color);
+		return;
+	}
+
+	FramePacket::Command command;
+	command.kind = FramePacket::Command::Kind::FillRect;
+	command.dst = rect;
+	command.hasDst = true;
+	command.color = color;
+	FramePacket::execute(renderer, command);
+}
+
+void DrawContext::copy(SDL_Texture* texture, const SDL_Rect* src, const SDL_Rect* dst) const
+{
+	if (packet)
+	{
+		packet->copy(texture, src, dst);
+		return;
+	}
+
+	SDL_RenderCopy(renderer, texture, src, dst);
+}
+
+void DrawContext::copyEx(SDL_Texture* texture, const SDL_Rect* src, const SDL_Rect* dst,
+	double angle, const SDL_Point* center, SDL_RendererFlip flip, Uint8 alpha) const
+{
+	if (packet)
+	{
+		packet->copyEx(texture, src, dst, angle, center, flip, alpha);
+		return;
+	}
+
+	FramePacket::Command command;
+	command.kind = FramePacket::Command::Kind::CopyEx;
+	command.texture = texture;
+	if (src) { command.src = *src; command.hasSrc = true; }
+	if (dst) { command.dst = *dst; command.hasDst = true; }
+	command.angle = angle;
+	if (center) { command.center = *center; command.hasCenter = true; }
+	command.flip = flip;
+	command.alpha = alpha;
+	FramePacket::execute(renderer, command);
+}
+
+void DrawContext::drawTextCentered(TTF_Font* font, const std::string& text,
+	int xCenter, int y, SDL_Color color, SDL_Color shadowColor, int shadowOffset) const
+{
+	if (packet)
+	{
+		packet->drawTextCentered(font, text, xCenter, y, color, shadowColor, shadowOffset);
+		return;
+	}
+
+	FramePacket::Command command;
+	command.kind = FramePacket::Command::Kind::Text;
+	command.font = font;
+	command.dst = SDL_Rect{ xCenter, y, 0, 0 };
+	command.color = color;
+	command.shadowColor = shadowColor;
+	command.shadowOffset = shadowOffset;
+	FramePacket::execute(renderer, command, text.c_str());
+}
+
+void DrawContext::drawText(TTF_Font* font, const std::string& text,
+	int x, int y, SDL_Color color, SDL_Color shadowColor, int shadowOffset) const
+{
+	if (packet)
+	{
+		packet->drawText(font, text, x, y, color, shadowColor, shadowOffset);
+		return;
+	}
+
+	FramePacket::Command command;
+	command.kind = FramePacket::Command::Kind::Text;
+	command.font = font;
+	command.dst = SDL_Rect{ x, y, 0, 0 };
+	command.centered = false;
+	command.color = color;
+	command.shadowColor = shadowColor;
+	command.shadowOffset = shadowOffset;
+	FramePacket::execute(renderer, command, text.c_str());
+}
+
 void DrawContext::applyTarget() const
 {
 	SDL_SetRenderTarget(renderer, renderTarget);
@@ -1,9 +1,12 @@
 #pragma once
 #include "SDL.h"
 #include "SDL_ttf.h"
+#include <string>
 
 namespace ssge
 {
+	class FramePacket;
+
 	class DrawContext
 	{
 		SDL_Renderer* renderer = nullptr;
@@ -13,6 +16,12 @@ namespace ssge
 		SDL_Point scrollOffset = { 0,0 };
 		SDL_Texture* renderTarget = nullptr;
 		TTF_Font* font = nullptr;
+		// How far the render is between the previous and the current tick.
+		// 0 = previous tick's state, 1 = current tick's state
+		float interpolation = 1.0f;
+		// If set, drawing is recorded here instead of issued to the renderer
+		// (the render thread replays it later)
+		FramePacket* packet = nullptr;
 
 	public:
 		DrawContext(SDL_Renderer* const renderer);
@@ -34,6 +43,10 @@ namespace ssge
 		SDL_Point getScrollOffset() const;
 		SDL_Point calculateAnchorPoint() const;
 		TTF_Font* getFont();
+		float getInterpolation() const;
+
+		// Blends a position from the previous tick towards the current one
+		SDL_FPoint interpolate(SDL_FPoint previous, SDL_FPoint current) const;
 
 		// Context derivation
 
@@ -41,6 +54,26 @@ namespace ssge
 		DrawContext deriveForScrolling(SDL_Point offset) const;
 		DrawContext deriveForEntity(SDL_FPoint entityPosition) const;
 		DrawContext deriveWithFont(TTF_Font* font) const;
+		DrawContext deriveWithInterpolation(float interpolation) const;
+		DrawContext deriveForRecording(FramePacket* packet) const;
+
+		// Drawing
+		// These either draw right away or record into the FramePacket.
+		// Scenes, entities and menus should draw through these rather than
+		// calling SDL_Render* on getRenderer() themselves.
+
+		bool isRecording() const;
+		void fillRect(const SDL_Rect& rect, SDL_Color color) const;
+		void copy(SDL_Texture* texture, const SDL_Rect* src, const SDL_Rect* dst) const;
+		void copyEx(SDL_Texture* texture, const SDL_Rect* src, const SDL_Rect* dst,
+			double angle, const SDL_Point* center, SDL_RendererFlip flip,
+			Uint8 alpha = 255) const;
+		void drawTextCentered(TTF_Font* font, const std::string& text,
+			int xCenter, int y, SDL_Color color,
+			SDL_Color shadowColor = { 0,0,0,0 }, int shadowOffset = 0) const;
+		void drawText(TTF_Font* font, const std::string& text,
+			int x, int y, SDL_Color color,
+			SDL_Color shadowColor = { 0,0,0,0 }, int shadowOffset = 0) const;
 
 		// SDL function help
 
@@ -2,6 +2,7 @@
 #include <SDL.h>
 #include <SDL_ttf.h>
 #include <memory>
+#include <algorithm>
 #include "PassKey.h"
 #include "SceneManager.h"
 #include "WindowManager.h"
@@ -13,16 +14,37 @@
 #include "Accessor.h"
 #include "DrawContext.h"
 #include "GameWorld.h"
+#include "RenderGate.h"
+#include "FramePacket.h"
+#include "FramePacer.h"
+#include "Profiler.h"
+#include "EventBus.h"
+#include "JobPool.h"
+#include "RenderBatch.h"
 
 using namespace ssge;
 
-Engine::Engine(PassKey<Program> pk, IGame& game) : game(game)
+Engine::Engine(PassKey<Program> pk, IGame& game, EngineOptions options) :
+	game(game),
+	options(options)
 {
 	window = new WindowManager(PassKey<Engine>());
 	audio = new AudioManager(PassKey<Engine>());
 	scenes = new SceneManager(PassKey<Engine>());
 	inputs = new InputManager(PassKey<Engine>());
 	menus = new MenuManager(PassKey<Engine>());
+	gate = new RenderGate(PassKey<Engine>());
+	profiler = new Profiler(PassKey<Engine>());
+	events = new EventBus();
+	profiler->setOverlayVisible(options.profile);
+
+	// Trace from the very start, so initial loading is in it too
+	Profiler::nameThread("Main");
+	if (!options.tracePath.empty()
+		&& !profiler->startTrace(PassKey<Engine>(), options.tracePath, options.traceFrames))
+	{
+		std::cout << "Tracing is unavailable (profiler compiled out)" << std::endl;
+	}
 }
 
 Engine::~Engine()
@@ -39,6 +61,12 @@ bool Engine::init(PassKey<Program> pk)
 	// TODO: May need to be parametrized in the future if it causes problems
 	SDL_SetHint(SDL_HINT_JOYSTICK_ALLOW_BACKGROUND_EVENTS, "1");
 
+	if (options.headless)
+	{ // No display, no GPU, no sound card. Must be set before SDL_Init!
+		SDL_SetHint(SDL_HINT_VIDEODRIVER, "dummy");
+		SDL_SetHint(SDL_HINT_AUDIODRIVER, "dummy");
+	}
+
 	do // Gotophobia
 	{
 		// Initialize SDL
@@ -54,6 +82,13 @@ bool Engine::init(PassKey<Program> pk)
 		// Initialize input stuff via InputManager
 		inputs->init(PassKey<Engine>());
 
+		// Worker threads for loading, stepping and whatever else fans out
+		int workers = options.jobs;
+		if (workers == 0)
+			workers = std::min(std::max(SDL_GetCPUCount(), 1), 8);
+		jobs = new JobPool(PassKey<Engine>(), workers);
+		std::cout << "Job pool: " << jobs->getWorkerCount() << " threads" << std::endl;
+
 		// Initialize SDL_image for PNG support
 		int imgFlags = IMG_INIT_PNG;
 		if (!(IMG_Init(imgFlags) & imgFlags))
@@ -67,7 +102,9 @@ bool Engine::init(PassKey<Program> pk)
 		if (auto error = window->init(
 			game.getApplicationTitle(),
 			game.getVirtualWidth(),
-			game.getVirtualHeight())
+			game.getVirtualHeight(),
+			options.headless,
+			options.vsync)
 			)
 		{
 			std::cout << "WindowManager init error: " << error << std::endl;
@@ -83,8 +120,13 @@ bool Engine::init(PassKey<Program> pk)
 			break;
 		}
 
-		// Initialize audio
-		if (!audio->init(PassKey<Engine>()))
+		// Initialize audio (headless runs take the null audio path)
+		if (options.headless)
+		{
+			std::cout << "Headless mode. Continuing without sound..."
+				<< std::endl;
+		}
+		else if (!audio->init(PassKey<Engine>()))
 		{
 			std::cout << "AudioManager init failed. Continuing without sound..."
 				<< std::endl;
@@ -122,6 +164,13 @@ bool Engine::loadInitialResources(SDL_Renderer* renderer)
 		success = false;
 	}
 
+	// Overlays can do without it
+	overlayFont = TTF_OpenFont("Fonts/VCR_OSD_MONO.ttf", 14);
+	if (overlayFont == nullptr)
+	{
+		std::cout << TTF_GetError() << std::endl;
+	}
+
 	return success;
 }
 
@@ -131,18 +180,22 @@ bool Engine::initGame()
 		0, // Zero delta-time
 		EngineAccess(this),
 		GameAccess(game),
-		WindowAccess(window),
+		WindowAccess(window, gate),
 		AudioAccess(audio),
 		ScenesAccess(scenes, game),
 		InputsAccessConfigurable(inputs),
-		DrawingAccess(window->getRenderer()),
-		MenusAccess(menus));
+		DrawingAccess(window->getRenderer(), gate),
+		MenusAccess(menus),
+		EventsAccess(events));
 
 	return game.init(stepContext);
 }
 
 bool Engine::mainLoop(PassKey<Program> pk)
 {
+	if (options.headless)
+		return headlessLoop();
+
 	SDL_Renderer* renderer = window->getRenderer();
 
 	const int virtualWidth = game.getVirtualWidth();
@@ -152,14 +205,23 @@ bool Engine::mainLoop(PassKey<Program> pk)
 	SDL_RenderSetLogicalSize(renderer, virtualWidth, virtualHeight);
 	SDL_RenderSetIntegerScale(renderer, SDL_FALSE);
 
-	// Fixed timestep
-	const double fps = 60.0;
-	const Uint32 deltaTimeMS = (Uint32)(1000.0 / fps + 0.5); // 16 or 17 ms
-	const Uint32 MAX_STEPS = 5;                        // frameskip cap
-	const double deltaTime = (double)deltaTimeMS / 1000.0f;
+	if (options.threaded)
+	{
+		if (threadedLoop(renderer))
+			return false;
+
+		std::cout << "Couldn't start the simulation thread. "
+			"Continuing single-threaded..." << std::endl;
+	}
+
+	// Fixed timestep, frameskip capped at 5 ticks per frame
+	FramePacer pacer(options.tickRate, chooseFrameRate());
+	pacer.setMaxTicksPerFrame(5);
 
-	Uint32 prevTicks = SDL_GetTicks();
-	Uint32 accumulatorMS = 0;
+	// Frames are recorded and replayed right away, so quads get batched
+	// here the same as on the render thread
+	FramePacket packet;
+	RenderBatch batch(options.batching);
 
 	bool done = false;
 
@@ -168,98 +230,356 @@ bool Engine::mainLoop(PassKey<Program> pk)
 	//       and afterMainLoop.
 	while (!done)
 	{
-		handleEvents();
-
-		// Update time passed
-		Uint32 now = SDL_GetTicks();
-		Uint32 frameMS = now - prevTicks;
-		prevTicks = now;
-
-		// Clamp huge stalls (alt-tab, breakpoint, etc.)
-		if (frameMS > 250) frameMS = 250;
+		profiler->beginFrame(PassKey<Engine>());
 
-		// Accumulate time
-		accumulatorMS += frameMS;
+		handleEvents();
+		jobs->serveMainThread(PassKey<Engine>());
 
-		// Prevent spiral of deadth by limiting frameskip to MAX_STEPS
-		unsigned steps = 0;
-		while (accumulatorMS >= deltaTimeMS && steps < MAX_STEPS)
+		// Accumulate time passed and see how many ticks are due
+		unsigned steps = pacer.advance();
+		for (unsigned step = 0; step < steps && !done; step++)
 		{
 			// Additional responsiveness
 			handleEvents();
 			// Update the engine and see if it's done (wants to quit)
-			done |= !tick(deltaTime);
-			accumulatorMS -= deltaTimeMS;
-			steps++;
+			done |= !tick(pacer.getTickDelta());
+			pacer.consumeTick();
 		}
 
-		SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
-		SDL_RenderClear(renderer);
-		render(DrawContext(renderer, virtualWidth, virtualHeight));
-		SDL_RenderPresent(renderer);
+		// Leftover time tells how far we are towards the next tick.
+		// Drawing blends the last two ticks by it, so high refresh rate
+		// displays get smooth motion without extra simulation ticks.
+		float interpolation = pacer.getInterpolation();
+
+		packet.clear();
+		render(DrawContext(renderer, virtualWidth, virtualHeight)
+			.deriveWithInterpolation(interpolation)
+			.deriveForRecording(&packet));
 
-		// Cooperative yield (keeps XP/old drivers happy)
-		if (accumulatorMS < frameMS)
 		{
-			SDL_Delay(1);
+			SSGE_PROFILE_ZONE("FramePacket::replay");
+			SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+			SDL_RenderClear(renderer);
+			packet.replay(renderer, batch);
 		}
+		profiler->setDrawStats(PassKey<Engine>(),
+			batch.getStats().drawCalls, batch.getStats().quads);
+
+		// Work is done, the rest is waiting for the display
+		profiler->endFrame(PassKey<Engine>());
+
+		SDL_RenderPresent(renderer);
+
+		// Vsync already waited in SDL_RenderPresent.
+		// Otherwise the pacer sleeps (then spins) until the next frame.
+		pacer.waitForNextFrame();
 	}
 
+	pacer.printStatistics("Frame pacing");
+
 	return false;
 }
 
-void Engine::handleEvents()
+int Engine::chooseFrameRate() const
 {
-	SDL_Event event;
-	while (SDL_PollEvent(&event))
+	// Explicit cap wins
+	if (options.frameRate > 0)
+		return options.frameRate;
+
+	// Vsync paces us by itself
+	if (window->hasVsync())
+		return 0;
+
+	// No vsync: don't draw more often than we simulate
+	return options.tickRate;
+}
+
+bool Engine::headlessLoop()
+{
+	// Same simulation step as the windowed loop, but without waiting for it
+	const double fps = (double)options.tickRate;
+	const double deltaTime = 1.0 / fps;
+
+	std::cout << "Headless run: ";
+	if (options.ticks)
+		std::cout << options.ticks << " ticks" << std::endl;
+	else
+		std::cout << "until the game finishes" << std::endl;
+
+	const Uint64 frequency = SDL_GetPerformanceFrequency();
+	const Uint64 start = SDL_GetPerformanceCounter();
+
+	unsigned long long ticksDone = 0;
+	bool done = false;
+
+	while (!done && (!options.ticks || ticksDone < options.ticks))
+	{
+		profiler->beginFrame(PassKey<Engine>());
+
+		// Dummy driver still queues quit and device events
+		handleEvents();
+		jobs->serveMainThread(PassKey<Engine>());
+		done |= !tick(deltaTime);
+		ticksDone++;
+
+		profiler->endFrame(PassKey<Engine>());
+	}
+
+	const Uint64 elapsed = SDL_GetPerformanceCounter() - start;
+	const double seconds = (double)elapsed / (double)frequency;
+
+	std::cout << "Headless run finished: " << ticksDone << " ticks in "
+		<< seconds << " s";
+	if (seconds > 0)
+		std::cout << " (" << (double)ticksDone / seconds << " ticks/s, "
+			<< (double)ticksDone / seconds / fps << "x realtime)";
+	std::cout << std::endl;
+
+	return false;
+}
+
+bool Engine::threadedLoop(SDL_Renderer* renderer)
+{
+	eventsMutex = SDL_CreateMutex();
+	if (!eventsMutex)
+		return false;
+
+	if (!gate->begin(PassKey<Engine>()))
+	{
+		SDL_DestroyMutex(eventsMutex);
+		eventsMutex = nullptr;
+		return false;
+	}
+
+	frames = new FramePacketExchange();
+
+	SDL_AtomicSet(&simulationRunning, 1);
+	SDL_Thread* simulationThread = SDL_CreateThread(
+		&Engine::simulationThreadMain, "ssge-simulation", this);
+
+	if (simulationThread)
 	{
-		switch (event.type)
+		std::cout << "Simulation runs on its own thread" << std::endl;
+
+		// Frame cap only matters with vsync off
+		FramePacer presentPacer(options.tickRate, chooseFrameRate());
+		RenderBatch batch(options.batching);
+
+		// This thread owns the window and the renderer.
+		// It polls events, runs renderer jobs for the simulation, and
+		// presents the latest recorded frame. It never waits on the
+		// simulation, so a vsync stall doesn't delay the next tick.
+		while (SDL_AtomicGet(&simulationRunning))
 		{
-		case SDL_QUIT:
-			// Game implementation handles quit requests!
-			game.queryQuit();
-			break;
-		// Keyboard events
-		case SDL_EventType::SDL_KEYDOWN:
-		case SDL_EventType::SDL_KEYUP:
-		// Mouse events
-		case SDL_EventType::SDL_MOUSEBUTTONDOWN:
-		case SDL_EventType::SDL_MOUSEBUTTONUP:
-		case SDL_EventType::SDL_MOUSEWHEEL:
-		// Joystick events
-		case SDL_EventType::SDL_JOYBUTTONDOWN:
-		case SDL_EventType::SDL_JOYBUTTONUP:
-		case SDL_EventType::SDL_JOYAXISMOTION:
-		case SDL_EventType::SDL_JOYBALLMOTION:
-		case SDL_EventType::SDL_JOYHATMOTION:
-		case SDL_EventType::SDL_JOYDEVICEADDED:
-		case SDL_EventType::SDL_JOYDEVICEREMOVED:
-		// GameController events
-		case SDL_EventType::SDL_CONTROLLERDEVICEADDED:
-		case SDL_EventType::SDL_CONTROLLERDEVICEREMOVED:
-		case SDL_EventType::SDL_CONTROLLERBUTTONDOWN:
-		case SDL_EventType::SDL_CONTROLLERBUTTONUP:
-		case SDL_EventType::SDL_CONTROLLERAXISMOTION:
-			// InputManager handles all of these
-			inputs->handle(event);
-			break;
-		default:
-			break;
+			SDL_Event event;
+			SDL_LockMutex(eventsMutex);
+			while (SDL_PollEvent(&event))
+				pendingEvents.push_back(event);
+			SDL_UnlockMutex(eventsMutex);
+
+			gate->serve(PassKey<Engine>());
+			jobs->serveMainThread(PassKey<Engine>());
+
+			if (const FramePacket* packet = frames->acquireLatest())
+			{
+				// Older packets are gone, so are their textures
+				gate->collectRetired(PassKey<Engine>(), packet->sequence);
+
+				{
+					SSGE_PROFILE_ZONE("FramePacket::replay");
+					SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+					SDL_RenderClear(renderer);
+					packet->replay(renderer, batch);
+					SDL_RenderPresent(renderer);
+				}
+				profiler->setDrawStats(PassKey<Engine>(),
+					batch.getStats().drawCalls, batch.getStats().quads);
+
+				presentPacer.waitForNextFrame();
+			}
+			else
+			{ // Nothing new to show yet
+				SDL_Delay(1);
+			}
 		}
 
-		// Game implementation handles things too!
+		SDL_WaitThread(simulationThread, nullptr);
 
-		if (event.type == SDL_EventType::SDL_JOYDEVICEREMOVED
-			|| event.type == SDL_EventType::SDL_CONTROLLERDEVICEREMOVED)
+		presentPacer.printStatistics("Frame pacing (render thread)");
+	}
+	else
+	{
+		std::cout << "SDL_CreateThread error: " << SDL_GetError() << std::endl;
+		SDL_AtomicSet(&simulationRunning, 0);
+	}
+
+	gate->end(PassKey<Engine>());
+
+	delete frames;
+	frames = nullptr;
+
+	SDL_DestroyMutex(eventsMutex);
+	eventsMutex = nullptr;
+	pendingEvents.clear();
+	dispatchingEvents.clear();
+
+	return simulationThread != nullptr;
+}
+
+int Engine::simulationThreadMain(void* engine)
+{
+	Engine* self = static_cast<Engine*>(engine);
+	Profiler::nameThread("Simulation");
+	self->simulationLoop();
+	SDL_AtomicSet(&self->simulationRunning, 0);
+	return 0;
+}
+
+void Engine::simulationLoop()
+{
+	SDL_Renderer* renderer = window->getRenderer();
+
+	const int virtualWidth = game.getVirtualWidth();
+	const int virtualHeight = game.getVirtualHeight();
+
+	// Fixed timestep (same as mainLoop). Frames are paced by the render thread.
+	FramePacer pacer(options.tickRate);
+	pacer.setMaxTicksPerFrame(5);
+
+	bool done = false;
+
+	while (!done)
+	{
+		profiler->beginFrame(PassKey<Engine>());
+
+		dispatchPendingEvents();
+
+		unsigned steps = pacer.advance();
+		for (unsigned step = 0; step < steps && !done; step++)
+		{
+			dispatchPendingEvents();
+			done |= !tick(pacer.getTickDelta());
+			pacer.consumeTick();
+		}
+
+		// Record a new frame if something changed or the render thread
+		// already took the last one (interpolation moves on either way)
+		bool recorded = false;
+		if (steps > 0 || !frames->isPending())
+		{
+			float interpolation = pacer.getInterpolation();
+
+			FramePacket& packet = frames->beginWrite();
+			render(DrawContext(renderer, virtualWidth, virtualHeight)
+				.deriveWithInterpolation(interpolation)
+				.deriveForRecording(&packet));
+			gate->markPublished(PassKey<Engine>(), frames->publish());
+			recorded = true;
+		}
+
+		// Nothing to do until the next tick or the next frame request.
+		// Short naps keep XP/old drivers happy without missing either.
+		if (!recorded)
 		{
-			// Game implementation handles joypad unplugging
-			game.joypadGotUnplugged();
+			// Idle iterations would only flatten the graph
+			if (steps == 0)
+				profiler->discardFrame(PassKey<Engine>());
+			else
+				profiler->endFrame(PassKey<Engine>());
+
+			pacer.waitForNextTick(1000);
 		}
+		else
+		{
+			profiler->endFrame(PassKey<Engine>());
+		}
+	}
+}
+
+void Engine::dispatchPendingEvents()
+{
+	SDL_LockMutex(eventsMutex);
+	dispatchingEvents.swap(pendingEvents);
+	SDL_UnlockMutex(eventsMutex);
+
+	for (const auto& event : dispatchingEvents)
+		dispatchEvent(event);
+	dispatchingEvents.clear();
+}
+
+void Engine::handleEvents()
+{
+	SDL_Event event;
+	while (SDL_PollEvent(&event))
+	{
+		dispatchEvent(event);
+	}
+}
+
+void Engine::dispatchEvent(const SDL_Event& event)
+{
+	// Engine's own debug keys
+	if (event.type == SDL_KEYDOWN && !event.key.repeat
+		&& event.key.keysym.sym == SDLK_F3)
+	{
+		profiler->toggleOverlay();
+	}
+
+	switch (event.type)
+	{
+	case SDL_QUIT:
+		// Game implementation handles quit requests!
+		events->post(QuitRequestedEvent{});
+		break;
+	// Keyboard events
+	case SDL_EventType::SDL_KEYDOWN:
+	case SDL_EventType::SDL_KEYUP:
+	// Mouse events
+	case SDL_EventType::SDL_MOUSEBUTTONDOWN:
+	case SDL_EventType::SDL_MOUSEBUTTONUP:
+	case SDL_EventType::SDL_MOUSEWHEEL:
+	// Joystick events
+	case SDL_EventType::SDL_JOYBUTTONDOWN:
+	case SDL_EventType::SDL_JOYBUTTONUP:
+	case SDL_EventType::SDL_JOYAXISMOTION:
+	case SDL_EventType::SDL_JOYBALLMOTION:
+	case SDL_EventType::SDL_JOYHATMOTION:
+	case SDL_EventType::SDL_JOYDEVICEADDED:
+	case SDL_EventType::SDL_JOYDEVICEREMOVED:
+	// GameController events
+	case SDL_EventType::SDL_CONTROLLERDEVICEADDED:
+	case SDL_EventType::SDL_CONTROLLERDEVICEREMOVED:
+	case SDL_EventType::SDL_CONTROLLERBUTTONDOWN:
+	case SDL_EventType::SDL_CONTROLLERBUTTONUP:
+	case SDL_EventType::SDL_CONTROLLERAXISMOTION:
+		// InputManager handles all of these
+		inputs->handle(event);
+		break;
+	// Renderer events
+	case SDL_EventType::SDL_RENDER_TARGETS_RESET:
+	case SDL_EventType::SDL_RENDER_DEVICE_RESET:
+		// Whoever caches render targets has to draw them again
+		renderTargetResets++;
+		break;
+	default:
+		break;
+	}
+
+	// Game implementation handles things too!
+
+	// Game controllers are joysticks as well, so this catches both
+	// (and only once per unplugged device)
+	if (event.type == SDL_EventType::SDL_JOYDEVICEREMOVED)
+	{
+		// Game implementation handles joypad unplugging
+		events->post(JoypadUnpluggedEvent{ event.jdevice.which });
 	}
 }
 
 bool Engine::tick(double deltaTime)
 {
+	SSGE_PROFILE_ZONE("Engine::tick");
+
 	// Stop updating the engine if it's finished
 	if (wannaFinish)
 		return false;
@@ -277,16 +597,23 @@ bool Engine::tick(double deltaTime)
 		deltaTime,
 		EngineAccess(this),
 		GameAccess(game),
-		WindowAccess(window),
+		WindowAccess(window, gate),
 		AudioAccess(audio),
 		ScenesAccess(scenes, game),
 		InputsAccessConfigurable(inputs),
-		DrawingAccess(window->getRenderer()),
-		MenusAccess(menus)
+		DrawingAccess(window->getRenderer(), gate),
+		MenusAccess(menus),
+		EventsAccess(events)
 	);
 
+	// Events from SDL and from the end of the previous tick
+	events->drain(stepContext);
+
 	scenes->step(stepContext);
 
+	// Events from the scenes and entities (victory, hero death...)
+	events->drain(stepContext);
+
 	// Step the game implementation
 	game.step(stepContext);
 
@@ -304,29 +631,41 @@ bool Engine::tick(double deltaTime)
 			PassKey<Engine>(),
 			EngineAccess(this),
 			GameAccess(game),
-			WindowAccess(window),
+			WindowAccess(window, gate),
 			ScenesAccess(scenes, game),
 			InputsAccessConfigurable(inputs),
-			DrawingAccess(window->getRenderer()),
+			DrawingAccess(window->getRenderer(), gate),
 			MenusAccess(menus),
 			CurrentSceneAccess(currentScene),
 			GameWorldAccess(gameWorld),
-			LevelAccess(level)
+			LevelAccess(level),
+			EventsAccess(events)
 		);
 
 		menus->step(menuContext);
 	}
 
+	// Events from the game and the menus (saving settings...)
+	events->drain(stepContext);
+
 	// Let this be the final tick if we're finished
 	return !wannaFinish;
 }
 
 void Engine::render(DrawContext context)
 {
-	scenes->draw(context);
-	
-	auto menuDrawingCtx = context.deriveWithFont(menuFont);
-	menus->draw(menuDrawingCtx);
+	{
+		SSGE_PROFILE_ZONE("Engine::render");
+
+		scenes->draw(context);
+
+		auto menuDrawingCtx = context.deriveWithFont(menuFont);
+		menus->draw(menuDrawingCtx);
+	}
+
+	// Topmost, and not part of what it measures
+	auto overlayCtx = context.deriveWithFont(overlayFont);
+	profiler->drawOverlay(overlayCtx, 1000.0 / options.tickRate);
 }
 
 void Engine::shutdown()
@@ -339,12 +678,13 @@ void Engine::shutdown()
 		0,
 		EngineAccess(this),
 		GameAccess(game),
-		WindowAccess(window),
+		WindowAccess(window, gate),
 		AudioAccess(audio),
 		ScenesAccess(scenes, game),
 		InputsAccessConfigurable(inputs),
-		DrawingAccess(window->getRenderer()),
-		MenusAccess(menus)
+		DrawingAccess(window->getRenderer(), gate),
+		MenusAccess(menus),
+		EventsAccess(events)
 	);
 	game.saveSettings(context);
 
@@ -357,6 +697,25 @@ void Engine::shutdown()
 		menuFont = nullptr;
 	}
 
+	if (overlayFont)
+	{ // Close overlay font
+		TTF_CloseFont(overlayFont);
+		overlayFont = nullptr;
+	}
+
+	if (events)
+	{ // Delete EventBus (after the game, it holds the game's handlers)
+		delete events;
+		events = nullptr;
+	}
+
+	if (profiler)
+	{ // Write the trace if it's still running, then delete Profiler
+		profiler->stopTrace(PassKey<Engine>());
+		delete profiler;
+		profiler = nullptr;
+	}
+
 	if (inputs)
 	{ // Delete InputManager
 		delete inputs;
@@ -375,6 +734,18 @@ void Engine::shutdown()
 		scenes = nullptr;
 	}
 
+	if (jobs)
+	{ // Delete JobPool (after the scenes that step on it)
+		delete jobs;
+		jobs = nullptr;
+	}
+
+	if (gate)
+	{ // Delete RenderGate
+		delete gate;
+		gate = nullptr;
+	}
+
 	if (window)
 	{ // Delete WindowManager
 		delete window;
@@ -404,4 +775,19 @@ void Engine::wrapUp()
 bool Engine::isWrappingUp() const
 {
 	return wannaWrapUp;
+}
+
+const EngineOptions& Engine::getOptions() const
+{
+	return options;
+}
+
+JobPool* Engine::getJobs() const
+{
+	return jobs;
+}
+
+uint32_t Engine::getRenderTargetResets() const
+{
+	return renderTargetResets;
 }
\ No newline at end of file
@@ -1,7 +1,9 @@
 #pragma once
 #include "SDL.h"
 #include "PassKey.h"
+#include "EngineOptions.h"
 #include <SDL_ttf.h>
+#include <vector>
 
 namespace ssge
 {
@@ -14,6 +16,11 @@ namespace ssge
 	class MenuManager;
 	class Scene;
 	class DrawContext;
+	class RenderGate;
+	class FramePacketExchange;
+	class Profiler;
+	class EventBus;
+	class JobPool;
 
 	class Engine // Super Shiny Game Engine core class
 	{
@@ -30,6 +37,8 @@ namespace ssge
 
 		// Interface to the game's implementation
 		IGame& game;
+		// Launch-time switches (headless etc.)
+		const EngineOptions options;
 		// Manages the window
 		WindowManager* window;
 		// Manages audio
@@ -43,22 +52,50 @@ namespace ssge
 		// Manages menus
 		MenuManager* menus;
 
+		// Keeps renderer and window work on the render thread
+		RenderGate* gate;
+
+		// Built-in profiler and its overlay (F3)
+		Profiler* profiler;
+
+		// Typed events for the game (victory, quit requests etc.)
+		// Drained at fixed points of tick()
+		EventBus* events;
+
+		// Worker threads for the whole engine (see EngineOptions::jobs).
+		// Its main thread queue is served once per frame.
+		JobPool* jobs = nullptr;
+
+		// Threaded mode only (see EngineOptions::threaded)
+		// Recorded frames going from the simulation to the render thread
+		FramePacketExchange* frames = nullptr;
+		// Events polled by the render thread for the simulation thread
+		SDL_mutex* eventsMutex = nullptr;
+		std::vector<SDL_Event> pendingEvents;
+		std::vector<SDL_Event> dispatchingEvents;
+		// Non-zero while the simulation thread runs
+		SDL_atomic_t simulationRunning{};
+
 		// Fonts for menus
 		// TODO: Font management during major CRTP overhaul (v0.2)
 		TTF_Font* menuFont = nullptr;
+		// Small font for debug overlays
+		TTF_Font* overlayFont = nullptr;
 
 		// Tells the Engine it's time to shut down
 		// Set by finish()
-		// TODO: Mailboxes/events
 		bool wannaFinish = false;
 		// Tells the Engine to gracefully shut down (e.g. fade out)
 		// Set by wrapUp()
-		// TODO: Mailboxes/events
 		bool wannaWrapUp = false;
+		// Bumped whenever the renderer loses what was drawn into its
+		// render targets (device reset)
+		uint32_t renderTargetResets = 0;
 	public:
 		// Only Program is allowed to create Engine,
 		// and it must bring the concrete implementation of the game
-		Engine(PassKey<Program> pk, IGame& game);
+		Engine(PassKey<Program> pk, IGame& game,
+			EngineOptions options = EngineOptions());
 		Engine(const Engine& toCopy) = delete; // No Engine copies!
 		Engine(Engine&& toMove) = delete; // Engine stays put!
 		~Engine(); // Program destroys Engine. Dtor calls shutdown() basically
@@ -80,8 +117,24 @@ namespace ssge
 		// Only Program is allowed to call this!
 		bool mainLoop(PassKey<Program> pk);
 	private:
+		// Main loop for headless mode: ticks back to back, never renders,
+		// never sleeps, and reports ticks per second at the end.
+		bool headlessLoop();
+		// Frame cap for the pacer: explicit option, or the tick rate if the
+		// renderer has no vsync, or 0 (vsync paces)
+		int chooseFrameRate() const;
+		// Main loop for threaded mode, run by the main (render) thread.
+		// Returns false if the simulation thread couldn't be started.
+		bool threadedLoop(SDL_Renderer* renderer);
+		// Simulation thread's loop: ticks and records frame packets
+		void simulationLoop();
+		static int simulationThreadMain(void* engine);
+		// Hands events queued by the render thread over to dispatchEvent
+		void dispatchPendingEvents();
 		// Handles event
 		void handleEvents();
+		// Handles a single event
+		void dispatchEvent(const SDL_Event& event);
 		// Ticks the engine. This is where step functions are called.
 		bool tick(double deltaTime);
 		// Lets the engine draw
@@ -100,5 +153,11 @@ namespace ssge
 		void wrapUp();
 		// Tells whether the Engine is performing a graceful shutdown
 		bool isWrappingUp() const;
+		// Launch-time switches
+		const EngineOptions& getOptions() const;
+		// The engine's worker threads (one, the caller, when running serially)
+		JobPool* getJobs() const;
+		// Changes whenever render target contents were lost
+		uint32_t getRenderTargetResets() const;
 	};
 }
\ No newline at end of file
@@ -0,0 +1,164 @@
+#include "EngineOptions.h"
+#include <cerrno>
+#include <cstring>
+#include <cstdlib>
+#include <iostream>
+
+using namespace ssge;
+
+// Parses the number following argv[i] and moves i over it
+static bool parseNumber(int argc, char* argv[], int& i, unsigned long long& value)
+{
+	const char* name = argv[i];
+
+	if (i + 1 >= argc)
+	{
+		std::cout << name << " expects a number" << std::endl;
+		return false;
+	}
+
+	// strtoull would take "-1" and wrap it, and "" as 0
+	const char* text = argv[++i];
+	if (*text < '0' || *text > '9')
+	{
+		std::cout << name << " expects a number, got: " << text << std::endl;
+		return false;
+	}
+
+	char* end = nullptr;
+	errno = 0;
+	value = std::strtoull(text, &end, 10);
+	if (errno == ERANGE || !end || *end != '\0')
+	{
+		std::cout << name << " expects a number, got: " << argv[i] << std::endl;
+		return false;
+	}
+
+	return true;
+}
+
+bool EngineOptions::parse(int argc, char* argv[])
+{
+	bool success = true;
+
+	// argv[0] is the program itself
+	for (int i = 1; i < argc; i++)
+	{
+		const char* arg = argv[i];
+
+		if (std::strcmp(arg, "--headless") == 0)
+		{
+			headless = true;
+		}
+		else if (std::strcmp(arg, "--threaded") == 0)
+		{
+			threaded = true;
+		}
+		else if (std::strcmp(arg, "--profile") == 0)
+		{
+			profile = true;
+		}
+		else if (std::strcmp(arg, "--trace") == 0)
+		{
+			if (i + 1 >= argc)
+			{
+				std::cout << "--trace expects a file path" << std::endl;
+				success = false;
+				break;
+			}
+			tracePath = argv[++i];
+		}
+		else if (std::strcmp(arg, "--trace-frames") == 0)
+		{
+			unsigned long long value = 0;
+			if (!parseNumber(argc, argv, i, value) || value > 1000000)
+			{
+				std::cout << "--trace-frames expects 0..1000000" << std::endl;
+				success = false;
+				break;
+			}
+			traceFrames = (int)value;
+		}
+		else if (std::strcmp(arg, "--bench-entities") == 0)
+		{
+			unsigned long long value = 0;
+			if (!parseNumber(argc, argv, i, value) || value > 10000000)
+			{
+				std::cout << "--bench-entities expects 0..10000000" << std::endl;
+				success = false;
+				break;
+			}
+			benchEntities = (int)value;
+		}
+		else if (std::strcmp(arg, "--jobs") == 0)
+		{
+			unsigned long long value = 0;
+			if (!parseNumber(argc, argv, i, value) || value > 64)
+			{
+				std::cout << "--jobs expects 0..64" << std::endl;
+				success = false;
+				break;
+			}
+			jobs = (int)value;
+			parallelStep = true;
+		}
+		else if (std::strcmp(arg, "--state-hash") == 0)
+		{
+			unsigned long long value = 0;
+			if (!parseNumber(argc, argv, i, value) || value > 1000000)
+			{
+				std::cout << "--state-hash expects 0..1000000" << std::endl;
+				success = false;
+				break;
+			}
+			stateHash = (int)value;
+		}
+		else if (std::strcmp(arg, "--no-vsync") == 0)
+		{
+			vsync = false;
+		}
+		else if (std::strcmp(arg, "--no-batch") == 0)
+		{
+			batching = false;
+		}
+		else if (std::strcmp(arg, "--ticks") == 0)
+		{
+			unsigned long long value = 0;
+			if (!parseNumber(argc, argv, i, value) || value == 0 || value > 1000000000)
+			{
+				std::cout << "--ticks expects 1..1000000000" << std::endl;
+				success = false;
+				break;
+			}
+			ticks = value;
+		}
+		else if (std::strcmp(arg, "--rate") == 0)
+		{
+			unsigned long long value = 0;
+			if (!parseNumber(argc, argv, i, value) || value == 0 || value > 1000)
+			{
+				std::cout << "--rate expects 1..1000 Hz" << std::endl;
+				success = false;
+				break;
+			}
+			tickRate = (int)value;
+		}
+		else if (std::strcmp(arg, "--fps") == 0)
+		{
+			unsigned long long value = 0;
+			if (!parseNumber(argc, argv, i, value) || value > 1000)
+			{
+				std::cout << "--fps expects 0..1000 Hz" << std::endl;
+				success = false;
+				break;
+			}
+			frameRate = (int)value;
+		}
+		else
+		{
+			std::cout << "Ignoring unknown argument: " << arg << std::endl;
+		}
+	}
+
+	return success;
+}
@@ -0,0 +1,85 @@
+#pragma once
+#include <string>
+
+namespace ssge
+{
+	// Launch-time switches for the Engine.
+	// Program fills these in from the command line and hands them over
+	// to the Engine before init().
+	struct EngineOptions
+	{
+		// Run without a visible window, GPU or sound card.
+		// Uses SDL's dummy video/audio drivers and a software renderer.
+		// Set by --headless
+		bool headless = false;
+
+		// How many ticks to simulate in headless mode before finishing.
+		// 0 (no --ticks) means "until the game finishes on its own".
+		// Set by --ticks N
+		unsigned long long ticks = 0;
+
+		// Simulation ticks per second.
+		// Set by --rate HZ
+		int tickRate = 60;
+
+		// Frames per second cap. 0 = automatic: vsync paces the frames,
+		// or the tick rate caps them if there's no vsync.
+		// Set by --fps HZ
+		int frameRate = 0;
+
+		// Ask for a vsynced renderer.
+		// Cleared by --no-vsync
+		bool vsync = true;
+
+		// Draw runs of quads that share a texture with one
+		// SDL_RenderGeometry call (see RenderBatch). The profiler overlay
+		// shows the draw calls either way.
+		// Cleared by --no-batch
+		bool batching = true;
+
+		// Run the simulation on its own thread. The main thread only
+		// handles events and replays the recorded frames.
+		// Set by --threaded
+		bool threaded = false;
+
+		// Show the profiler overlay from the start (F3 toggles it).
+		// Set by --profile
+		bool profile = false;
+
+		// Write a Chrome trace-event JSON file (chrome://tracing, Perfetto).
+		// Set by --trace PATH
+		std::string tracePath;
+
+		// How many frames to trace before writing the file.
+		// 0 means "until the engine shuts down".
+		// Set by --trace-frames N
+		int traceFrames = 600;
+
+		// Threads in the engine's JobPool, counting the main thread
+		// (1 = everything on the main thread, 0 = one per CPU core, up
+		// to 8).
+		// Set by --jobs N
+		int jobs = 0;
+
+		// Step entities (postStep, the physics batch) on the JobPool's
+		// threads. Off unless asked for, results are the same either
+		// way, see stateHash.
+		// Set by --jobs N
+		bool parallelStep = false;
+
+		// Prints a hash of the game world every this many ticks (0 = off),
+		// for checking that serial and parallel runs agree.
+		// Set by --state-hash N
+		int stateHash = 0;
+
+		// Times entity step context setup with this many entities
+		// when a level starts (0 = off).
+		// Set by --bench-entities N
+		int benchEntities = 0;
+
+		// Parses command line arguments.
+		// Unknown arguments are reported and ignored.
+		// Returns false if an argument is malformed.
+		bool parse(int argc, char* argv[]);
+	};
+}
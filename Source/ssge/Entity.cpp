@@ -5,7 +5,10 @@
 #include "Utilities.h"
 #include "Level.h"
 #include "InputSet.h"
+#include "PhysicsBatch.h"
+#include "EntityManager.h"
 #include <cmath>
+#include <cstring>
 
 using namespace ssge;
 
@@ -20,19 +23,31 @@ Entity::Physics::Physics(Entity& entity)
 {
 }
 
-inline static SDL_FRect makeWorldAABB(const SDL_FPoint& pos, const SDL_FRect& localHitbox)
+using PhysicsBox = Level::Box<PhysicsReal>;
+
+inline static PhysicsBox makeWorldAABB(const Entity::Physics::Vector& pos, const SDL_FRect& localHitbox)
 {
-    return SDL_FRect{ pos.x + localHitbox.x, pos.y + localHitbox.y, localHitbox.w, localHitbox.h };
+    return PhysicsBox{ pos.x + PhysicsReal(localHitbox.x), pos.y + PhysicsReal(localHitbox.y),
+        PhysicsReal(localHitbox.w), PhysicsReal(localHitbox.h) };
 }
 
-inline static void applyResolvedWorldAABBToEntity(SDL_FPoint& pos, const SDL_FRect& localHitbox, const SDL_FRect& worldAABB)
+inline static void applyResolvedWorldAABBToEntity(Entity::Physics::Vector& pos, const SDL_FRect& localHitbox, const PhysicsBox& worldAABB)
 {
     // localHitbox is relative to pos, so pos = worldBox - localOffset
-    pos.x = floor(worldAABB.x - localHitbox.x);
-    pos.y = floor(worldAABB.y - localHitbox.y);
+    pos.x = floorOf(worldAABB.x - PhysicsReal(localHitbox.x));
+    pos.y = floorOf(worldAABB.y - PhysicsReal(localHitbox.y));
 }
 
 void Entity::Physics::step(EntityStepContext& context)
+{
+    // A body on its own. EntityManager runs these phases itself,
+    // with integrate() batched over all bodies (see PhysicsBatch).
+    prepare();
+    integrate();
+    sweep(context);
+}
+
+void Entity::Physics::prepare()
 {
 	// Platformer Physics
 
@@ -186,77 +201,56 @@ void Entity::Physics::step(EntityStepContext& context)
                 jumpTimer = abilities.jumpStrength;
             }
         }
+    }
+}
 
-        // Offer the ability to move horizontally
-        if (abilities.horzMove())
-        {
-            velocity.x += sign(side.x) * abilities.acc.x;
-            if (abs(velocity.x) > abilities.maxSpeedHor)
-            {
-                velocity.x = sign(velocity.x) * abilities.maxSpeedHor;
-            }
-        }
-        // Offer the ability to move vertically
-        if (abilities.vertMove())
-        {
-            velocity.y += sign(side.y) * abilities.acc.y;
-            if ((velocity.y < 0) && (-velocity.y > abilities.maxSpeedUp))
-            {
-                velocity.y = sign(velocity.y) * abilities.maxSpeedUp;
-            }
-            if (velocity.y > abilities.maxSpeedDown)
-            {
-                velocity.y = sign(velocity.y) * abilities.maxSpeedDown;
-            }
-        }
-        // Deccellerate
-        if (side.x == 0 || abilities.acc.x == 0)
-        {
-            if (abilities.dec.x > abs(velocity.x))
-            {
-                velocity.x = 0;
-            }
-            else
-            {
-                velocity.x -= sign(velocity.x) * abilities.dec.x;
-            }
-        }
-        if ((side.y == 0 || abilities.acc.y == 0) && jumpTimer == 0 && abilities.gravity == 0)
-        {
-            if (abilities.dec.y > abs(velocity.y))
-            {
-                velocity.y = 0;
-            }
-            else
-            {
-                velocity.y -= sign(velocity.y) * abilities.dec.y;
-            }
-        }
-        // Apply jump
-        if (jumpTimer > 0)
-        {
-            if (velocity.y >= -abilities.jumpSpeed)
-            {
-                jumpTimer--;
-                velocity.y = -abilities.jumpSpeed;
-            }
-        }
-        else if (side.y == 0)
-        {
-            //if (inWater)
-            //{
-            //    velocity.y += gravityInWater;
-            //}
-            //else
-            //{
-                velocity.y += abilities.gravity;
-                if (velocity.y > abilities.maxSpeedDown)
-                {
-                    velocity.y = sign(velocity.y) * abilities.maxSpeedDown;
-                }
-            //}
-        }
+void Entity::Physics::integrate()
+{
+    if (!abilities.physicsEnabled())
+        return;
+
+    takeOverChanges();
+    PhysicsReal timer = (float)jumpTimer;
+    PhysicsBatch::integrateBody((uint32_t)abilities.bits,
+        PhysicsReal(side.x), PhysicsReal(side.y),
+        abilities.acc.x, abilities.acc.y, abilities.dec.x, abilities.dec.y,
+        abilities.maxSpeedHor, abilities.maxSpeedUp, abilities.maxSpeedDown,
+        abilities.gravity, abilities.jumpSpeed,
+        exactVelocity.x, exactVelocity.y, timer);
+    jumpTimer = toFloat(timer);
+    publish();
+}
+
+// Bit for bit, so -0 and NaN count as changes too
+inline static bool changed(float now, float published)
+{
+    return std::memcmp(&now, &published, sizeof(float)) != 0;
+}
+
+void Entity::Physics::takeOverChanges()
+{
+    // Only what changed: re-reading an unchanged float would round the
+    // exact value to it
+    if (changed(position.x, publishedPosition.x)) exactPosition.x = position.x;
+    if (changed(position.y, publishedPosition.y)) exactPosition.y = position.y;
+    if (changed(velocity.x, publishedVelocity.x)) exactVelocity.x = velocity.x;
+    if (changed(velocity.y, publishedVelocity.y)) exactVelocity.y = velocity.y;
+}
+
+void Entity::Physics::publish()
+{
+    position.x = toFloat(exactPosition.x);
+    position.y = toFloat(exactPosition.y);
+    velocity.x = toFloat(exactVelocity.x);
+    velocity.y = toFloat(exactVelocity.y);
+    publishedPosition = position;
+    publishedVelocity = velocity;
+}
 
+void Entity::Physics::sweep(EntityStepContext& context)
+{
+    if (abilities.physicsEnabled())
+    {
         // COLLISION
         // Leftover from 2013's GML code
         // TODO: Port in v0.1.4
@@ -275,9 +269,12 @@ void Entity::Physics::step(EntityStepContext& context)
           }
         }*/
 
+        // Runs on the exact state, in PhysicsReal
+        takeOverChanges();
+
         // Step-based displacement
-        float dx = velocity.x;
-        float dy = velocity.y;
+        PhysicsReal dx = exactVelocity.x;
+        PhysicsReal dy = exactVelocity.y;
 
         bool collisionEnabled = !abilities.collisionIgnored();
         bool horzCollision = abilities.horzCollision() && collisionEnabled;
@@ -285,25 +282,25 @@ void Entity::Physics::step(EntityStepContext& context)
 
         // We'll apply axis-separated resolution: X then Y, using level sweeps.
         // Build world-space AABB from (position + local hitbox)
-        SDL_FRect box = makeWorldAABB(position, hitbox);
+        PhysicsBox box = makeWorldAABB(exactPosition, hitbox);
 
         // HORIZONTAL
         bool applyx = true;
-        if (horzCollision && dx != 0.f)
+        if (horzCollision && dx != PhysicsReal(0))
         {
-            Level::SweepHit hx = context.level.sweepHorizontal(box, dx);
+            Level::BasicSweepHit<PhysicsReal> hx = context.level.sweepHorizontal(box, dx);
             if (hx.hit)
             {
                 // We hit a solid tile�resolve at boundary and zero x-velocity (or bounce if enabled)
                 box.x = hx.newX;
                 if (abilities.horzBounce() && !abilities.gmBounce())
                 {
-                    velocity.x = -velocity.x;
+                    exactVelocity.x = -exactVelocity.x;
                     applyx = false; // bounce handled position; don�t re-apply afterwards
                 }
                 else
                 {
-                    velocity.x = 0.f;
+                    exactVelocity.x = 0;
                 }
                 touchesWall = true;
                 // optional: store hx.tile if you want terraforming later
@@ -316,9 +313,9 @@ void Entity::Physics::step(EntityStepContext& context)
             {
                 // If we didn't bounce-position, adopt the new x
                 // Convert resolved world AABB back to entity position (x only)
-                SDL_FRect tmp = box;
-                tmp.y = position.y + hitbox.y; // keep current y for now
-                applyResolvedWorldAABBToEntity(position, hitbox, tmp);
+                PhysicsBox tmp = box;
+                tmp.y = exactPosition.y + PhysicsReal(hitbox.y); // keep current y for now
+                applyResolvedWorldAABBToEntity(exactPosition, hitbox, tmp);
             }
         }
         else
@@ -326,37 +323,37 @@ void Entity::Physics::step(EntityStepContext& context)
             touchesWall = false;
             if (applyx)
             {
-                position.x += velocity.x;
+                exactPosition.x += exactVelocity.x;
             }
         }
 
         // VERTICAL
         bool applyy = true;
-        if (vertCollision && !abilities.collisionIgnored() && dy != 0.f)
+        if (vertCollision && !abilities.collisionIgnored() && dy != PhysicsReal(0))
         {
-            Level::SweepHit hy = context.level.sweepVertical(box, dy);
+            Level::BasicSweepHit<PhysicsReal> hy = context.level.sweepVertical(box, dy);
             if (hy.hit)
             {
                 box.y = hy.newY;
                 if (abilities.vertBounce() && !abilities.gmBounce())
                 {
-                    velocity.y = -velocity.y;
+                    exactVelocity.y = -exactVelocity.y;
                     applyy = false;
                 }
                 else
                 {
                     // landing logic
-                    if (dy > 0.f)
+                    if (dy > PhysicsReal(0))
                     {
                         // moving down -> ground
                         grounded = true;
                     }
-                    if (dy < 0.f)
+                    if (dy < PhysicsReal(0))
                     {
                         // bonked head -> stop jump
                         jumpTimer = 0.0;
                     }
-                    velocity.y = 0.f;
+                    exactVelocity.y = 0;
                 }
                 // optional: terraforming hook with hy.tile
             }
@@ -368,7 +365,7 @@ void Entity::Physics::step(EntityStepContext& context)
             if (applyy)
             {
                 // Convert resolved world AABB back to entity position (y now included)
-                applyResolvedWorldAABBToEntity(position, hitbox, box);
+                applyResolvedWorldAABBToEntity(exactPosition, hitbox, box);
             }
         }
         else
@@ -376,24 +373,17 @@ void Entity::Physics::step(EntityStepContext& context)
             grounded = false;
             if (applyy)
             {
-                position.y += velocity.y;
+                exactPosition.y += exactVelocity.y;
             }
         }
 
         if (vertCollision)
         {
             // Probe 1px below to keep grounded accurate when dy is ~0
-            SDL_FRect probe = box;
-            probe.w -= 1; // FIXME: This bodge fixes the broken jump
-            probe.y += 1;
-            int c0, c1, r0, r1;
-            context.level.rectToBlockSpan(probe, c0, c1, r0, r1);
-            bool onSolid = false;
-            for (int r = r0; r <= r1; ++r)
-                for (int c = c0; c <= c1; ++c)
-                    if (context.level.queryBlock(c, r).coll == Level::Block::Collision::Solid)
-                        onSolid = true;
-            grounded = grounded || onSolid;
+            PhysicsBox probe = box;
+            probe.w -= PhysicsReal(1); // FIXME: This bodge fixes the broken jump
+            probe.y += PhysicsReal(1);
+            grounded = grounded || context.level.rectInSolid(probe);
         }
 
         if (collisionEnabled)
@@ -402,6 +392,8 @@ void Entity::Physics::step(EntityStepContext& context)
             // Detect if any overlapped tile is water; update state:
             inWater = context.level.rectInWater(box);
         }
+
+        publish();
     }
 }
 
@@ -419,7 +411,31 @@ void ssge::Entity::latch(EntityStepContext& context)
 
 void Entity::step(EntityStepContext& context)
 {
-	double deltaTime = context.deltaTime;
+	beginStep(context);
+
+	// The velocity phase, for this entity alone
+	if (physics)
+	{
+		physics->integrate();
+	}
+
+	endStep(context);
+}
+
+void Entity::beginStep(PassKey<EntityManager> pk, EntityStepContext& context)
+{
+	beginStep(context);
+}
+
+void Entity::endStep(PassKey<EntityManager> pk, EntityStepContext& context)
+{
+	endStep(context);
+}
+
+void Entity::beginStep(EntityStepContext& context)
+{
+	// Remember where we were for render interpolation
+	previousPosition = position;
 
 	// If this is the entity's first step, execute it
 	if (lifespan == 0)
@@ -430,10 +446,21 @@ void Entity::step(EntityStepContext& context)
 	// First, execute the entity-specific pre-step code
 	preStep(context);
 
-	// Now we process physics (if we have them, that is)
+	// Physics read the pad and handle jumping and swimming
 	if (physics)
 	{
-		physics->step(context);
+		physics->prepare();
+	}
+}
+
+void Entity::endStep(EntityStepContext& context)
+{
+	double deltaTime = context.deltaTime;
+
+	// Physics collide with the level
+	if (physics)
+	{
+		physics->sweep(context);
 	}
 
 	// Finally, execute the entity-specific post-step code
@@ -463,7 +490,63 @@ void Entity::draw(DrawContext context) const
 
 void Entity::destroy()
 {
+	if (scheduledToDestroy)
+		return;
+
 	scheduledToDestroy = true;
+
+	// Keeps the manager's live counts current
+	if (manager)
+		manager->onScheduledToDestroy(PassKey<Entity>(), *this, slot);
+}
+
+void Entity::hashState(StateHash& hash) const
+{
+	hash.add(getEntityClassID().getIndex());
+	hash.add(lifespan);
+	hash.add(scheduledToDestroy);
+	hash.add(position.x);
+	hash.add(position.y);
+	hash.add(previousPosition.x);
+	hash.add(previousPosition.y);
+	hash.add(hitbox.x);
+	hash.add(hitbox.y);
+	hash.add(hitbox.w);
+	hash.add(hitbox.h);
+
+	if (physics)
+	{
+		hash.add(physics->abilities.bits);
+		hash.add(physics->velocity.x);
+		hash.add(physics->velocity.y);
+		hash.add(physics->oldVelocity.x);
+		hash.add(physics->oldVelocity.y);
+		hash.add(physics->jumpTimer);
+		hash.add(physics->side.x);
+		hash.add(physics->side.y);
+		hash.add(physics->dir.x);
+		hash.add(physics->dir.y);
+		hash.add(physics->running);
+		hash.add(physics->inWater);
+		hash.add(physics->grounded);
+		hash.add(physics->touchesWall);
+#if SSGE_FIXED_PHYSICS
+		hash.add(physics->exactPosition.x.getRaw());
+		hash.add(physics->exactPosition.y.getRaw());
+		hash.add(physics->exactVelocity.x.getRaw());
+		hash.add(physics->exactVelocity.y.getRaw());
+#endif
+	}
+
+	if (sprite)
+	{
+		hash.add(sprite->getSeqIdx());
+		hash.add(sprite->getCurrentAnimationFrame());
+		hash.add(sprite->isFinished());
+		hash.add(sprite->xscale);
+		hash.add(sprite->yscale);
+		hash.add(sprite->angle);
+	}
 }
 
 Entity::Control::Control(Entity& entity) : entity(entity)
@@ -5,16 +5,22 @@
 #include "InputPad.h"
 #include <cstdint>
 #include <string>
+#include "ClassID.h"
+#include "ObjectPool.h"
+#include "PassKey.h"
+#include "Fixed.h"
 
 namespace ssge
 {
 	class EntityStepContext;
 	class DrawContext;
+	class EntityManager;
+	class StateHash;
 
 	class Entity
 	{
 	public:
-		class Control
+		class Control : public Pooled<Control>
 		{
 		public:
 			Entity& entity;
@@ -94,7 +100,7 @@ namespace ssge
 			// Think of it like the NPC's actual joystick
 			uint32_t directInputs;
 		};
-		class Physics
+		class Physics : public Pooled<Physics>
 		{
 		public:
 			// Limits of physical movement
@@ -209,6 +215,20 @@ namespace ssge
 			SDL_Point side = { 0,0 };   // Side that's being pushed
 			SDL_FPoint oldVelocity = { 0,0 };
 
+			// What the phases below actually step, in PhysicsReal (see
+			// Fixed.h). With float physics it just follows position and
+			// velocity. With fixed-point physics it is the state itself:
+			// position and velocity are published from it after each
+			// phase, and what game code writes there in between is taken
+			// over before the next one.
+			struct Vector
+			{
+				PhysicsReal x = 0;
+				PhysicsReal y = 0;
+			};
+			Vector exactPosition;
+			Vector exactVelocity;
+
 			// TODO: Refactor these as Abilities in air, in water, etc.
 			// Probably v0.1.4+
 			//float gravityInWater = 0;
@@ -245,6 +265,23 @@ namespace ssge
 			Entity& entity;
 			Physics(Entity& entity);
 			void step(EntityStepContext& context);
+
+			// The phases of step():
+			// Reads the pad, starts jumps and swim strokes
+			void prepare();
+			// Accelerates, decelerates, clamps, jumps and falls (PhysicsBatch)
+			void integrate();
+			// Moves through the level and updates grounded, inWater, etc.
+			void sweep(EntityStepContext& context);
+
+			// Takes over position and velocity where game code changed them
+			void takeOverChanges();
+			// Writes the exact state out to position and velocity
+			void publish();
+
+		private:
+			SDL_FPoint publishedPosition = { 0,0 };
+			SDL_FPoint publishedVelocity = { 0,0 };
 		};
 
 	private:
@@ -254,6 +291,10 @@ namespace ssge
 		// Internal flag that is set when the entity is scheduled to be destroyed
 		bool scheduledToDestroy{ false };
 
+		// Manager the entity was added to (told when it's scheduled to be destroyed)
+		EntityManager* manager = nullptr;
+		uint32_t slot = 0; // In the manager's storage
+
 	protected:
 		std::unique_ptr<Control> control;
 		std::unique_ptr<Physics> physics;
@@ -261,8 +302,8 @@ namespace ssge
 	public:
 		Entity();
 
-		// EntityClassID is a string that represents the implementation of the Entity.
-		virtual std::string getEntityClassID() const = 0;
+		// EntityClassID is an interned name that represents the implementation of the Entity.
+		virtual ClassID getEntityClassID() const = 0;
 
 		// Returns the age of Entity in steps
 		uint32_t getLifespan() const { return lifespan; }
@@ -270,15 +311,43 @@ namespace ssge
 		// Returns whether the entity is scheduled to be destroyed at the end of Entity iterations for this frame
 		bool isScheduledToDestroy() const { return scheduledToDestroy; }
 
+		// EntityManager attaches itself when the entity is added
+		void attach(PassKey<EntityManager> pk, EntityManager* manager, uint32_t slot) {
+			this->manager = manager;
+			this->slot = slot;
+		}
+
 		// Entity position in the GameWorld
 		SDL_FPoint position{ 0.0f, 0.0f };
 
+		// Entity position at the start of the current step.
+		// Drawing blends between this and position.
+		SDL_FPoint previousPosition{ 0.0f, 0.0f };
+
+		// Makes the Entity appear at its position right away instead of
+		// sliding there from the previous step (e.g. after teleporting)
+		void snapInterpolation() { previousPosition = position; }
+
 		// Entity's sprite
 		std::unique_ptr<Sprite> sprite;
 
+		// Lower layers are drawn first. Within a layer, entities of one
+		// class are drawn together (by ClassID index), in the order they
+		// were added. Give a class its own layer to put it above others.
+		int drawLayer = 0;
+
+		// Keeps stepping however far it is from the view
+		// (see EntityManager::setActiveRect)
+		bool alwaysActive = false;
+
 		// Entity's local hitbox relative to the Entity's position
 		SDL_FRect hitbox{ 0.0f, 0.0f, 0.0f, 0.0f };
 
+		// The hitbox where it currently is in the GameWorld
+		SDL_FRect getWorldHitbox() const {
+			return SDL_FRect{ position.x + hitbox.x, position.y + hitbox.y, hitbox.w, hitbox.h };
+		}
+
 		// Gets the object responsible for controlling the Entity
 		Control* getControl();
 
@@ -291,6 +360,12 @@ namespace ssge
 		// Updates the local InputPad with necessary inputs
 		void latch(EntityStepContext& context);
 
+	private:
+		void beginStep(EntityStepContext& context);
+		void endStep(EntityStepContext& context);
+
+	public:
+
 		// Callback that occurs on the first step
 		// Best for initializing the entity with EntityStepContext data
 		virtual void firstStep(EntityStepContext& context) = 0;
@@ -298,14 +373,28 @@ namespace ssge
 		// Callback that occurs before the standard step code for Entity does
 		virtual void preStep(EntityStepContext& context) = 0;
 
-		// Occurs every step. EntityManager calls this.
+		// Occurs every step.
 		void step(EntityStepContext& context);
 
-		// Callback that occurs after the standard step code for Entity does
+		// step() in two halves. EntityManager runs beginStep for every
+		// entity, then the physics velocity phase for all of them at once,
+		// then endStep for every entity.
+		void beginStep(PassKey<EntityManager> pk, EntityStepContext& context);
+		void endStep(PassKey<EntityManager> pk, EntityStepContext& context);
+
+		// Callback that occurs after the standard step code for Entity does.
+		// Runs on one thread unless --jobs N is given, then on up to N
+		// at once, so write it as if it were parallel. It may
+		// change its own entity, destroy() it and write blocks through
+		// context.level.setBlockType (applied once every entity is done).
+		// Spawning (addEntity refuses here), entity queries, events and
+		// audio belong in preStep.
 		virtual void postStep(EntityStepContext& context) = 0;
 
 		// Callback that occurs before the standard draw code for Entity does.
 		// Gamedev may want to do things with DrawContext.
+		// Entities whose sprite is off screen aren't drawn at all, so this
+		// doesn't run for them either.
 		virtual void preDraw(DrawContext& context) const = 0;
 
 		// Occurs every drawn frame. EntityManager calls this.
@@ -319,6 +408,9 @@ namespace ssge
 		// Gamedev can use this to colloquially "destroy" the "object".
 		void destroy();
 
+		// Feeds the engine-side state (position, physics, sprite) into a state hash
+		void hashState(StateHash& hash) const;
+
 		// Callback called by EntityManager after all entities have been stepped
 		virtual void onDestroy(EntityStepContext& context) = 0;
 
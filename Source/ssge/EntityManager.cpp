@@ -3,82 +3,359 @@
 #include "PassKey.h"
 #include <algorithm>
 #include "IGame.h"
+#include "Profiler.h"
+#include "JobPool.h"
+#include "EngineOptions.h"
+#include "Utilities.h"
+#include <iostream>
 
 using namespace ssge;
 
-inline ssge::EntityReference::EntityReference(const EntityAllocator& alloc)
-    : ref(alloc.getShared())
+uint32_t EntitySlotMap::takeSlot()
 {
+    uint32_t index;
+    if (firstFree != NO_SLOT)
+    { // Reuse a freed slot
+        index = firstFree;
+        firstFree = slots[index].nextFree;
+    }
+    else
+    {
+        index = (uint32_t)slots.size();
+        slots.push_back(Slot());
+    }
+    slots[index].nextFree = NO_SLOT;
+    return index;
+}
+
+EntityHandle EntitySlotMap::add(std::unique_ptr<Entity> entity)
+{
+    uint32_t index = takeSlot();
+    Slot& slot = slots[index];
+    slot.dense = (uint32_t)entities.size();
+
+    entities.push_back(std::move(entity));
+    slotOfEntity.push_back(index);
+
+    return EntityHandle{ index, slot.generation };
+}
+
+EntityHandle EntitySlotMap::addPending(std::unique_ptr<Entity> entity)
+{
+    uint32_t index = takeSlot();
+    Slot& slot = slots[index];
+    slot.dense = PENDING | (uint32_t)pending.size();
+
+    pending.push_back(std::move(entity));
+    slotOfPending.push_back(index);
+
+    return EntityHandle{ index, slot.generation };
+}
+
+void EntitySlotMap::commitPending()
+{
+    for (size_t i = 0; i < pending.size(); i++)
+    {
+        uint32_t index = slotOfPending[i];
+        slots[index].dense = (uint32_t)entities.size();
+        entities.push_back(std::move(pending[i]));
+        slotOfEntity.push_back(index);
+    }
+    pending.clear();
+    slotOfPending.clear();
+}
+
+void EntitySlotMap::reserve(size_t count)
+{
+    slots.reserve(count);
+    entities.reserve(count);
+    slotOfEntity.reserve(count);
+    pending.reserve(count);
+    slotOfPending.reserve(count);
+}
+
+void EntitySlotMap::removeAt(const std::vector<size_t>& positions)
+{
+    if (positions.empty())
+        return;
+
+    size_t next = 0; // Next position to remove
+    size_t write = positions[0];
+    for (size_t read = positions[0]; read < entities.size(); read++)
+    {
+        uint32_t index = slotOfEntity[read];
+        if (next < positions.size() && positions[next] == read)
+        { // Free the slot, stale handles stop resolving from here on
+            next++;
+            entities[read].reset();
+            Slot& slot = slots[index];
+            slot.generation++;
+            slot.dense = NO_SLOT;
+            slot.nextFree = firstFree;
+            firstFree = index;
+        }
+        else
+        { // Keep, moving down over the removed ones
+            if (write != read)
+            {
+                entities[write] = std::move(entities[read]);
+                slotOfEntity[write] = index;
+                slots[index].dense = (uint32_t)write;
+            }
+            write++;
+        }
+    }
+
+    entities.resize(write);
+    slotOfEntity.resize(write);
+}
+
+void EntitySlotMap::clear()
+{
+    commitPending();
+    std::vector<size_t> positions(entities.size());
+    for (size_t i = 0; i < positions.size(); i++)
+        positions[i] = i;
+    removeAt(positions);
+}
+
+EntityManager::~EntityManager() = default;
+
+EntityStepContext EntityManager::makeStepContext(GameWorldStepContext& context)
+{
+    return EntityStepContext(
+        PassKey<EntityManager>(),
+        context.deltaTime,
+        context.engine,
+        context.game,
+        context.scenes,
+        context.inputs,
+        context.drawing,
+        context.currentScene,
+        context.gameWorld,
+        context.level,
+        EntitiesAccessWCurrent(this, context.game),
+        SpritesAccess(context.game.get().getSprites()),
+        context.events
+    );
 }
 
 void EntityManager::step(GameWorldStepContext& context)
 {
-    // Step all entities
-    for (auto& entityPtr : entities)
+    SSGE_PROFILE_ZONE("EntityManager::step");
+
+    // Built once per tick, only the current entity changes per iteration
+    EntityStepContext entityStepContext = makeStepContext(context);
+
+    // Entities spawned during the tick wait in the command buffer, so
+    // the dense array stays put for the whole walk
+    const size_t count = entities.size();
+
+    // Dormant entities sit the tick out
+    awake.clear();
+    for (size_t i = 0; i < count; i++)
     {
-        EntityStepContext entityStepContext(
-            PassKey<EntityManager>(),
-            context.deltaTime,
-            context.engine,
-            context.game,
-            context.scenes,
-            context.inputs,
-            context.drawing,
-            context.currentScene,
-            context.gameWorld,
-            context.level,
-            EntitiesAccessWCurrent(this, context.game, entityPtr.get()),
-            SpritesAccess(context.game.get().getSprites())
-        );
+        if (isAwake(i))
+            awake.push_back((uint32_t)i);
+    }
 
-        entityPtr->latch(entityStepContext);
-        entityPtr->step(entityStepContext);
+    // First halves, up to the physics velocity phase
+    for (uint32_t i : awake)
+    {
+        SSGE_PROFILE_ZONE("Entity::beginStep");
+        Entity* entity = entities.at(i);
+        entityStepContext.rebind(PassKey<EntityManager>(), entity);
+        entity->latch(entityStepContext);
+        entity->beginStep(PassKey<EntityManager>(), entityStepContext);
     }
 
-    destroyScheduledEntities(context);
+    { // Velocity phase for every body in one go
+        SSGE_PROFILE_ZONE("PhysicsBatch::integrate");
+        physicsBatch.clear();
+        for (uint32_t i : awake)
+        {
+            if (auto physics = entities.at(i)->getPhysics())
+                physicsBatch.add(*physics);
+        }
+
+        // Only worth splitting for a lot of bodies, the loop is vectorized
+        if (JobPool* jobs = stepJobs(context))
+        {
+            jobs->parallelFor(physicsBatch.size(), 4096,
+                [this](size_t begin, size_t end, int worker) {
+                    physicsBatch.integrate(begin, end);
+                });
+        }
+        else
+        {
+            physicsBatch.integrate();
+        }
+        physicsBatch.scatter();
+    }
+
+    // Second halves: level sweeps and postStep
+    stepSecondHalves(context);
+
+    applyCommands(entityStepContext);
+    ticks++;
+}
+
+bool EntityManager::isAwake(size_t position) const
+{
+    if (!activeRectSet)
+        return true;
+
+    const Entity* entity = entities.at(position);
+    if (entity->alwaysActive || entity->getLifespan() == 0)
+        return true;
+
+    // Boxless entities count by their position
+    SDL_FRect box = entity->getWorldHitbox();
+    if (box.x < activeRect.x + activeRect.w && activeRect.x <= box.x + box.w &&
+        box.y < activeRect.y + activeRect.h && activeRect.y <= box.y + box.h)
+        return true;
+
+    // Staggered by slot so they don't all wake on the same tick
+    return dormantInterval && (ticks + entities.handleAt(position).index) % dormantInterval == 0;
+}
+
+void EntityManager::setActiveRect(const SDL_FRect& rect, uint32_t dormantInterval)
+{
+    activeRectSet = true;
+    activeRect = rect;
+    this->dormantInterval = dormantInterval;
+}
+
+void EntityManager::clearActiveRect()
+{
+    activeRectSet = false;
 }
 
 void EntityManager::draw(DrawContext& context)
 {
-    for (auto& entity : entities)
+    SSGE_PROFILE_ZONE("EntityManager::draw");
+
+    // Screen space, where the sprites' bounds land
+    SDL_Rect viewport = context.getBounds();
+    viewport.x = 0;
+    viewport.y = 0;
+    SDL_Point scroll = context.getScrollOffset();
+
+    drawList.clear();
+    for (size_t i = 0; i < entities.size(); i++)
     {
+        const Entity* entity = entities.at(i);
+
         // Don't draw an entity immediately! Give it time to initialize!
-        if (entity->getLifespan() > 0)
+        if (entity->getLifespan() == 0)
+            continue;
+
+        SDL_FPoint position = context.interpolate(entity->previousPosition, entity->position);
+
+        // Without a sprite there's nothing to tell where it draws, keep it
+        if (const Sprite* sprite = entity->sprite.get())
         {
-            DrawContext newContext = context.deriveForEntity(entity->position);
-            entity->draw(newContext);
+            SDL_Rect bounds = sprite->getBounds();
+            bounds.x += (int)position.x - scroll.x;
+            bounds.y += (int)position.y - scroll.y;
+            if (!SDL_HasIntersection(&bounds, &viewport))
+                continue;
         }
+
+        drawList.push_back(DrawItem{ entity->drawLayer,
+            entity->getEntityClassID().getIndex(), (uint32_t)i, entity, position });
     }
+
+    // Grouped by class, not by texture address: that would change the
+    // order of overlapping entities from run to run
+    std::sort(drawList.begin(), drawList.end(), [](const DrawItem& a, const DrawItem& b) {
+        if (a.layer != b.layer)
+            return a.layer < b.layer;
+        if (a.group != b.group)
+            return a.group < b.group;
+        return a.order < b.order;
+    });
+
+    for (const DrawItem& item : drawList)
+        item.entity->draw(context.deriveForEntity(item.position));
 }
 
-EntityCollection::iterator EntityManager::getEntitiesBegin()
+EntitySlotMap::const_iterator EntityManager::getEntitiesBegin() const
 {
     return entities.begin();
 }
 
-EntityCollection::iterator EntityManager::getEntitiesEnd()
+EntitySlotMap::const_iterator EntityManager::getEntitiesEnd() const
 {
     return entities.end();
 }
 
-EntityReference EntityManager::addEntity(std::shared_ptr<Entity> entity)
+EntityReference EntityManager::addEntity(std::unique_ptr<Entity> entity)
 {
     if (!entity)
         return EntityReference(nullptr);
 
-    EntityAllocator alloc(std::move(entity)); // consumes the caller's shared_ptr
-    entities.add(alloc);
-    return EntityReference(alloc); // from allocator
+    // postSteps may run in parallel and destroyedInPhase only covers the
+    // slots that existed before them. Spawning belongs in preStep.
+    if (deferDestroys)
+    {
+        std::cout << "EntityManager: can't add an entity from postStep, "
+            << "spawn it in preStep instead" << std::endl;
+        return EntityReference(nullptr);
+    }
+
+    uint32_t classIndex = entity->getEntityClassID().getIndex();
+    if (classIndex >= classes.size())
+        classes.resize(classIndex + 1);
+    EntityClassBucket& bucket = classes[classIndex];
+
+    bool alreadyDestroyed = entity->isScheduledToDestroy();
+    Entity* added = entity.get();
+    SDL_FRect box = entity->getWorldHitbox();
+
+    // Joins the iteration at the next applyCommands (or commitSpawns)
+    EntityHandle handle = entities.addPending(std::move(entity));
+    added->attach(PassKey<EntityManager>(), this, handle.index);
+    bucket.members.push_back(handle);
+
+    if (alreadyDestroyed)
+    {
+        destroyQueue.push_back(handle);
+    }
+    else
+    {
+        bucket.live++;
+        live++;
+    }
+    spatialHash.update(handle.index, box);
+    return EntityReference(entities, handle);
+}
+
+void EntityManager::reserve(size_t count)
+{
+    entities.reserve(count);
+    destroyed.reserve(count);
+    destroyQueue.reserve(count);
+    physicsBatch.reserve(count);
+    spatialHash.reserve(count);
+    foundSlots.reserve(count);
+    queryResult.reserve(count);
+
+    // Entities usually come with one of each
+    Entity::Physics::reservePool(count);
+    Entity::Control::reservePool(count);
+    Sprite::reservePool(count);
 }
 
 bool EntityManager::scheduleDestroy(EntityReference entity)
 {
-    auto it = std::find(entities.begin(), entities.end(), entity);
+    // Only entities of this manager
+    Entity* actual = entities.resolve(entity.getHandle());
 
-    if (it != entities.end())
+    if (actual && entity == EntityReference(entities, entity.getHandle()))
     {
         // Schedule the entity to get destroyed
-        (*it)->destroy();
+        actual->destroy();
         return true;
     }
     else
@@ -87,94 +364,318 @@ bool EntityManager::scheduleDestroy(EntityReference entity)
     }
 }
 
-Entity* EntityManager::findEntity(const std::string& entityClassID)
+EntityClassBucket* EntityManager::findClass(ClassID entityClassID)
+{
+    uint32_t index = entityClassID.getIndex();
+    return index < classes.size() ? &classes[index] : nullptr;
+}
+
+const EntityClassBucket* EntityManager::findClass(ClassID entityClassID) const
+{
+    uint32_t index = entityClassID.getIndex();
+    return index < classes.size() ? &classes[index] : nullptr;
+}
+
+Entity* EntityManager::findEntity(ClassID entityClassID)
+{
+    EntityClassView found = findAllEntities(entityClassID);
+    auto first = found.begin();
+    return first != found.end() ? first.get() : nullptr;
+}
+
+const Entity* EntityManager::findConstEntity(ClassID entityClassID) const
+{
+    EntityClassView found = findAllEntities(entityClassID);
+    auto first = found.begin();
+    return first != found.end() ? first.get() : nullptr;
+}
+
+EntityClassView EntityManager::findAllEntities(ClassID entityClassID) const
+{
+    const EntityClassBucket* bucket = findClass(entityClassID);
+    if (!bucket)
+        return EntityClassView();
+    return EntityClassView(entities, *bucket);
+}
+
+int EntityManager::countAllEntities() const
+{
+    return (int)live;
+}
+
+int EntityManager::countAllEntities(ClassID entityClassID) const
+{
+    const EntityClassBucket* bucket = findClass(entityClassID);
+    return bucket ? (int)bucket->live : 0;
+}
+
+void EntityManager::onScheduledToDestroy(PassKey<Entity> pk, Entity& entity, uint32_t slot)
+{
+    if (deferDestroys)
+    { // Second halves may be running in parallel, reported once they're done.
+        // addEntity refuses to run meanwhile, so every slot is covered.
+        if (slot < destroyedInPhase.size())
+            destroyedInPhase[slot] = 1;
+        return;
+    }
+
+    reportDestroyed(entities.handleOfSlot(slot), entity);
+}
+
+void EntityManager::reportDestroyed(EntityHandle handle, Entity& entity)
+{
+    destroyQueue.push_back(handle);
+
+    EntityClassBucket* bucket = findClass(entity.getEntityClassID());
+    if (bucket && bucket->live)
+        bucket->live--;
+    if (live)
+        live--;
+}
+
+JobPool* EntityManager::stepJobs(GameWorldStepContext& context)
 {
-    for (auto& entity : entities)
+    // The pool is there for loading anyway, stepping on it is opt-in
+    if (!context.engine.getOptions().parallelStep)
+        return nullptr;
+    return context.engine.getJobs();
+}
+
+void EntityManager::stepSecondHalves(GameWorldStepContext& context)
+{
+    SSGE_PROFILE_ZONE("Entity::endStep");
+
+    JobPool* jobs = stepJobs(context);
+    int workers = jobs ? jobs->getWorkerCount() : 1;
+
+    // Each worker steps with its own context and journals its own block
+    // writes. Serial stepping journals too, so the level every postStep
+    // sees is the one from before the second halves in both modes.
+    if ((int)journals.size() < workers)
+        journals.resize(workers);
+    for (auto& journal : journals)
+        journal.clear();
+
+    workerContexts.clear();
+    for (int worker = 0; worker < workers; worker++)
     {
-        if (entity->isScheduledToDestroy())
-        { // Don't count entities that are scheduled to be destroyed
-            continue;
+        workerContexts.push_back(makeStepContext(context));
+        workerContexts.back().level.setJournal(PassKey<EntityManager>(), &journals[worker]);
+    }
+
+    destroyedInPhase.assign(entities.slotCount(), 0);
+    deferDestroys = true;
+
+    JobPool::RangeJob endSteps = [this](size_t begin, size_t end, int worker) {
+        EntityStepContext& entityStepContext = workerContexts[worker];
+        Level::WriteJournal& journal = journals[worker];
+        for (size_t k = begin; k < end; k++)
+        {
+            uint32_t i = awake[k];
+            Entity* entity = entities.at(i);
+            journal.setOrder(i);
+            entityStepContext.rebind(PassKey<EntityManager>(), entity);
+            entity->endStep(PassKey<EntityManager>(), entityStepContext);
         }
-        if (entity->getEntityClassID() == entityClassID)
+    };
+
+    if (jobs)
+        jobs->parallelFor(awake.size(), END_STEP_GRAIN, endSteps);
+    else
+        endSteps(0, awake.size(), 0);
+
+    deferDestroys = false;
+
+    // Destroys in entity order, whichever worker saw them.
+    // Dormant entities didn't move, their cells are still right.
+    for (uint32_t i : awake)
+    {
+        EntityHandle handle = entities.handleAt(i);
+        if (destroyedInPhase[handle.index])
         {
-            return entity.get();
+            destroyedInPhase[handle.index] = 0;
+            reportDestroyed(handle, *entities.at(i));
         }
+        updateSpatialHash(i);
+    }
+    // Anything else (e.g. a pending spawn) by slot
+    for (uint32_t slot = 0; slot < destroyedInPhase.size(); slot++)
+    {
+        if (!destroyedInPhase[slot])
+            continue;
+        EntityHandle handle = entities.handleOfSlot(slot);
+        if (Entity* entity = entities.resolve(handle))
+            reportDestroyed(handle, *entity);
     }
-    return nullptr;
+
+    // Block writes in entity order, later entities winning
+    context.level.applyJournals(PassKey<EntityManager>(), journals, mergedWrites);
+}
+
+void EntityManager::hashState(StateHash& hash) const
+{
+    hash.add((uint64_t)entities.size());
+    for (const auto& entity : entities)
+        entity->hashState(hash);
 }
 
-const Entity* EntityManager::findConstEntity(const std::string& entityClassID) const
+void EntityManager::commitSpawns()
 {
-    for (auto& entity : entities)
+    entities.commitPending();
+}
+
+void EntityManager::applyCommands(GameWorldStepContext& context)
+{
+    EntityStepContext entityStepContext = makeStepContext(context);
+    applyCommands(entityStepContext);
+}
+
+void EntityManager::applyCommands(EntityStepContext& entityStepContext)
+{
+    // onDestroy pass, in the order entities were scheduled. Whatever
+    // onDestroy destroys queues up behind and is handled in this pass too.
+    for (size_t i = 0; i < destroyQueue.size(); i++)
     {
-        if (entity->isScheduledToDestroy())
-        { // Don't count entities that are scheduled to be destroyed
+        EntityHandle handle = destroyQueue[i];
+        Entity* entity = entities.resolve(handle);
+        if (!entity)
             continue;
-        }
-        if (entity->getEntityClassID() == entityClassID)
-        {
-            return entity.get();
-        }
+
+        entityStepContext.rebind(PassKey<EntityManager>(), entity);
+        entity->onDestroy(entityStepContext);
+
+        spatialHash.remove(handle.index);
+        if (auto bucket = findClass(entity->getEntityClassID()))
+            bucket->dirty = true;
+    }
+
+    // Spawns join the iteration, they step from the next tick on.
+    // They were filed before whoever spawned them put them in place.
+    size_t firstSpawn = entities.size();
+    commitSpawns();
+    for (size_t i = firstSpawn; i < entities.size(); i++)
+        updateSpatialHash(i);
+
+    // One compaction for everything destroyed
+    destroyed.clear();
+    for (EntityHandle handle : destroyQueue)
+    {
+        size_t position;
+        if (entities.positionOf(handle, position))
+            destroyed.push_back(position);
+    }
+    destroyQueue.clear();
+    std::sort(destroyed.begin(), destroyed.end());
+    entities.removeAt(destroyed);
+
+    // Drop the handles that stopped resolving, keeping the order
+    for (auto& bucket : classes)
+    {
+        if (!bucket.dirty)
+            continue;
+        bucket.dirty = false;
+        bucket.members.erase(
+            std::remove_if(bucket.members.begin(), bucket.members.end(),
+                [this](const EntityHandle& handle) { return !entities.resolve(handle); }),
+            bucket.members.end());
     }
-    return nullptr;
 }
 
-EntityQueryResult EntityManager::findAllEntities(const std::string& entityClassID)
+void EntityManager::setSpatialCellSize(float width, float height)
 {
-    EntityQueryResult foundEntities;
+    spatialHash.setCellSize(width, height);
+}
+
+void EntityManager::updateSpatialHash()
+{
+    for (size_t i = 0; i < entities.size(); i++)
+        updateSpatialHash(i);
+}
 
-    for (auto& entity : entities)
+void EntityManager::updateSpatialHash(size_t position)
+{
+    spatialHash.update(entities.handleAt(position).index, entities.at(position)->getWorldHitbox());
+}
+
+const EntityQueryResult& EntityManager::collectFound()
+{
+    queryResult.clear();
+    for (uint32_t slot : foundSlots)
     {
-        if (entity->isScheduledToDestroy())
-        { // Don't count entities that are scheduled to be destroyed
-            continue;
-        }
-        if (entity->getEntityClassID() == entityClassID)
-        {
-            foundEntities.push_back(entity);
-        }
+        EntityHandle handle = entities.handleOfSlot(slot);
+        Entity* entity = entities.resolve(handle);
+        if (entity && !entity->isScheduledToDestroy())
+            queryResult.push_back(EntityReference(entities, handle));
     }
-    return foundEntities;
+    return queryResult;
 }
 
-int EntityManager::countAllEntities() const
+const EntityQueryResult& EntityManager::queryRect(const SDL_FRect& rect)
+{
+    foundSlots.clear();
+    spatialHash.queryRect(rect, foundSlots);
+    return collectFound();
+}
+
+const EntityQueryResult& EntityManager::queryRadius(SDL_FPoint center, float radius)
+{
+    foundSlots.clear();
+    spatialHash.queryRadius(center, radius, foundSlots);
+    return collectFound();
+}
+
+const std::vector<EntityPair>& EntityManager::queryPairs()
 {
-    int count = 0;
+    foundSlotPairs.clear();
+    spatialHash.queryPairs(foundSlotPairs);
 
-    for (auto& entity : entities)
+    pairResult.clear();
+    for (const auto& slots : foundSlotPairs)
     {
-        if (entity->isScheduledToDestroy())
-        { // Don't count entities that are scheduled to be destroyed
+        EntityHandle first = entities.handleOfSlot(slots.first);
+        EntityHandle second = entities.handleOfSlot(slots.second);
+        Entity* firstEntity = entities.resolve(first);
+        Entity* secondEntity = entities.resolve(second);
+        if (!firstEntity || firstEntity->isScheduledToDestroy() ||
+            !secondEntity || secondEntity->isScheduledToDestroy())
             continue;
-        }
-        count++;
+        pairResult.push_back(EntityPair{
+            EntityReference(entities, first),
+            EntityReference(entities, second) });
     }
-    return count;
+    return pairResult;
 }
 
-int EntityManager::countAllEntities(const std::string& entityClassID) const
+void EntityManager::benchmarkStepContexts(GameWorldStepContext& context, int entityCount)
 {
-    int count = 0;
+    if (entities.empty() || entityCount <= 0)
+        return;
 
-    for (auto& entity : entities)
+    // Bind real entities (cycling through what the level has) but don't
+    // step them: this measures the per-entity context setup alone.
+    std::vector<Entity*> targets;
+    targets.reserve(entityCount);
+    while ((int)targets.size() < entityCount)
     {
-        if (entity->isScheduledToDestroy())
-        { // Don't count entities that are scheduled to be destroyed
-            continue;
-        }
-        if (entity->getEntityClassID() == entityClassID)
+        for (auto& entity : entities)
         {
-            count++;
+            if ((int)targets.size() == entityCount)
+                break;
+            targets.push_back(entity.get());
         }
     }
-    return count;
-}
 
-void EntityManager::destroyScheduledEntities(GameWorldStepContext& context)
-{
-    for (auto it = entities.begin(); it != entities.end(); )
+    const int ROUNDS = 20; // Best of, to skip warm-up and preemption
+    const double frequency = (double)SDL_GetPerformanceFrequency();
+    const void* volatile sink = nullptr; // A volatile pointer, so every store stays
+
+    double bestFresh = 0;
+    double bestRebound = 0;
+    for (int round = 0; round < ROUNDS; round++)
     {
-        if ((*it)->isScheduledToDestroy())
+        // Before: a fresh context per entity
+        Uint64 start = SDL_GetPerformanceCounter();
+        for (Entity* entity : targets)
         {
             EntityStepContext entityStepContext(
                 PassKey<EntityManager>(),
@@ -187,15 +688,34 @@ void EntityManager::destroyScheduledEntities(GameWorldStepContext& context)
                 context.currentScene,
                 context.gameWorld,
                 context.level,
-                EntitiesAccessWCurrent(this, context.game, it->get()),
-                SpritesAccess(context.game.get().getSprites())
+                EntitiesAccessWCurrent(this, context.game, entity),
+                SpritesAccess(context.game.get().getSprites()),
+                context.events
             );
-            (*it)->onDestroy(entityStepContext);
-            it = entities.erase(it);
+            sink = &entityStepContext.entities.getCurrent();
         }
-        else
+        double fresh = (double)(SDL_GetPerformanceCounter() - start) / frequency;
+
+        // After: one context per tick, rebound per entity
+        start = SDL_GetPerformanceCounter();
+        EntityStepContext entityStepContext = makeStepContext(context);
+        for (Entity* entity : targets)
         {
-            ++it;
+            entityStepContext.rebind(PassKey<EntityManager>(), entity);
+            sink = &entityStepContext.entities.getCurrent();
         }
+        double rebound = (double)(SDL_GetPerformanceCounter() - start) / frequency;
+
+        if (round == 0 || fresh < bestFresh) bestFresh = fresh;
+        if (round == 0 || rebound < bestRebound) bestRebound = rebound;
     }
-}
\ No newline at end of file
+    (void)sink;
+
+    const double toNS = 1e9 / (double)entityCount;
+    std::cout << "EntityStepContext setup, " << entityCount << " entities (best of "
+        << ROUNDS << "):" << std::endl;
+    std::cout << "  fresh per entity: " << bestFresh * toNS << " ns/entity, "
+        << bestFresh * 1000.0 << " ms/tick" << std::endl;
+    std::cout << "  rebound per tick: " << bestRebound * toNS << " ns/entity, "
+        << bestRebound * 1000.0 << " ms/tick" << std::endl;
+}
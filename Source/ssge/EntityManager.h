@@ -1,132 +1,182 @@
 #pragma once
 #include "PassKey.h"
 #include "Entity.h"
+#include "PhysicsBatch.h"
+#include "SpatialHash.h"
+#include "Level.h"
+#include <deque>
 #include <list>
 #include <memory>
 #include <vector>
 #include <iterator>
 #include <stdexcept>
+#include <cstdint>
 
 namespace ssge
 {
     // Forward declare
     class Entity;
-    class EntityAllocator;
     class EntityReference;
 
     class GameWorldStepContext;
+    class EntityStepContext;
     class DrawContext;
 
     class IGame;
     class IGameEntities;
 
-    class EntityReference {
-        std::weak_ptr<Entity> ref;
+    // Identifies an entity in an EntitySlotMap: which slot, and which
+    // occupant of that slot. Slots get reused, but every reuse bumps the
+    // generation, so handles of entities that are gone stop resolving.
+    struct EntityHandle {
+        uint32_t index = 0;
+        uint32_t generation = 0;
+
+        bool operator==(const EntityHandle& other) const {
+            return index == other.index && generation == other.generation;
+        }
+        bool operator!=(const EntityHandle& other) const { return !(*this == other); }
+    };
+
+    // Owning entity storage (slot map)
+    //  - Entities are kept densely in the order they were added, so
+    //    iterating them walks one contiguous array.
+    //  - Each slot points into that array. Resolving a handle is a bounds
+    //    check and a generation compare: no locking, no refcounting.
+    //  - Freed slots are reused through a free list.
+    //  - Entities can be added pending: their handle resolves right away,
+    //    but they only join the dense array (and get iterated) once
+    //    committed, so adding never disturbs a walk over the array.
+    class EntitySlotMap {
+        static const uint32_t NO_SLOT = 0xFFFFFFFFu;
+        static const uint32_t PENDING = 0x80000000u; // Slot::dense bit
+
+        struct Slot {
+            uint32_t generation = 1;
+            uint32_t dense = NO_SLOT;  // Position in entities (or pending), NO_SLOT when free
+            uint32_t nextFree = NO_SLOT;
+        };
+
+        std::vector<Slot> slots;
+        std::vector<std::unique_ptr<Entity>> entities; // Dense, in order of adding
+        std::vector<uint32_t> slotOfEntity;             // Parallel to entities
+        std::vector<std::unique_ptr<Entity>> pending;   // Added, not committed yet
+        std::vector<uint32_t> slotOfPending;            // Parallel to pending
+        uint32_t firstFree = NO_SLOT;
+
+        uint32_t takeSlot();
+
     public:
-        EntityReference() = default;
-        EntityReference(const std::weak_ptr<Entity>& r) : ref(r) {}
-        EntityReference(const std::shared_ptr<Entity>& r) : ref(r) {}
-        EntityReference(std::nullptr_t) noexcept : ref() {}
-        EntityReference(const EntityAllocator& alloc);
+        using const_iterator = std::vector<std::unique_ptr<Entity>>::const_iterator;
+
+        EntityHandle add(std::unique_ptr<Entity> entity);
+        EntityHandle addPending(std::unique_ptr<Entity> entity);
+        // Appends the pending entities to the dense array, in order
+        void commitPending();
+        size_t pendingCount() const { return pending.size(); }
+        size_t slotCount() const { return slots.size(); }
+        void reserve(size_t count);
+
+        // The entity a handle refers to, or nullptr if it's gone
+        Entity* resolve(EntityHandle handle) const {
+            if (handle.index >= slots.size())
+                return nullptr;
+            const Slot& slot = slots[handle.index];
+            if (slot.generation != handle.generation || slot.dense == NO_SLOT)
+                return nullptr;
+            if (slot.dense & PENDING)
+                return pending[slot.dense & ~PENDING].get();
+            return entities[slot.dense].get();
+        }
 
-        explicit operator bool() const noexcept { return !ref.expired(); }
+        // Dense position of a committed entity, false if it's gone or pending
+        bool positionOf(EntityHandle handle, size_t& position) const {
+            if (handle.index >= slots.size())
+                return false;
+            const Slot& slot = slots[handle.index];
+            if (slot.generation != handle.generation || slot.dense == NO_SLOT || (slot.dense & PENDING))
+                return false;
+            position = slot.dense;
+            return true;
+        }
 
-        Entity* operator->() {
-            auto sp = ref.lock();
-            return sp ? sp.get() : nullptr;
+        // Dense access. Positions shift when entities are removed.
+        Entity* at(size_t position) const { return entities[position].get(); }
+        EntityHandle handleAt(size_t position) const {
+            uint32_t index = slotOfEntity[position];
+            return EntityHandle{ index, slots[index].generation };
         }
-        const Entity* operator->() const {
-            auto sp = ref.lock();
-            return sp ? sp.get() : nullptr;
+        // Handle of whatever currently occupies a slot
+        EntityHandle handleOfSlot(uint32_t index) const {
+            return EntityHandle{ index, slots[index].generation };
         }
 
+        // Removes the entities at the given positions (ascending) and
+        // keeps the others in order
+        void removeAt(const std::vector<size_t>& positions);
+        // Removes everything, pending or not
+        void clear();
+
+        const_iterator begin() const { return entities.begin(); }
+        const_iterator end() const { return entities.end(); }
+        bool empty() const { return entities.empty(); }
+        size_t size() const { return entities.size(); }
+    };
+
+    // Non-owning reference to an entity, by handle.
+    // Must not outlive the EntityManager the entity was added to.
+    class EntityReference {
+        const EntitySlotMap* slots = nullptr;
+        EntityHandle handle;
+
+        Entity* resolve() const { return slots ? slots->resolve(handle) : nullptr; }
+    public:
+        EntityReference() = default;
+        EntityReference(std::nullptr_t) noexcept {}
+        EntityReference(const EntitySlotMap& slots, EntityHandle handle)
+            : slots(&slots), handle(handle) {}
+
+        explicit operator bool() const noexcept { return resolve() != nullptr; }
+
+        Entity* operator->() { return resolve(); }
+        const Entity* operator->() const { return resolve(); }
+
         Entity& operator*() {
-            auto sp = ref.lock();
-            if (!sp) throw std::runtime_error("Dereferencing expired EntityReference");
-            return *sp;
+            Entity* entity = resolve();
+            if (!entity) throw std::runtime_error("Dereferencing expired EntityReference");
+            return *entity;
         }
         const Entity& operator*() const {
-            auto sp = ref.lock();
-            if (!sp) throw std::runtime_error("Dereferencing expired EntityReference");
-            return *sp;
+            const Entity* entity = resolve();
+            if (!entity) throw std::runtime_error("Dereferencing expired EntityReference");
+            return *entity;
         }
         Entity* get() const {
-            auto sp = ref.lock();
+            Entity* entity = resolve();
 #ifndef NDEBUG
-            if (!sp) throw std::runtime_error("Dereferencing expired EntityReference");
+            if (!entity) throw std::runtime_error("Dereferencing expired EntityReference");
 #endif
-            return sp ? sp.get() : nullptr;
+            return entity;
         }
 
-        //std::shared_ptr<Entity> lock() const { return ref.lock(); }
+        EntityHandle getHandle() const { return handle; }
+
+        bool operator==(const EntityReference& other) const {
+            return slots == other.slots && handle == other.handle;
+        }
+        bool operator!=(const EntityReference& other) const { return !(*this == other); }
 
         // Casting helper
         template<typename T>
-        T* tryCast(std::string expectedID) const {
-            auto sp = ref.lock();
-            if (sp && sp->getEntityClassID() == expectedID) {
-                return dynamic_cast<T*>(sp.get());
+        T* tryCast(ClassID expectedID) const {
+            Entity* entity = resolve();
+            if (entity && entity->getEntityClassID() == expectedID) {
+                return dynamic_cast<T*>(entity);
             }
             return nullptr;
         }
     };
 
-    // Allocator (owning, like shared_ptr)
-    class EntityAllocator {
-        std::shared_ptr<Entity> ptr;
-    public:
-        EntityAllocator() = default;
-        EntityAllocator(const std::shared_ptr<Entity>& p) : ptr(p) {}
-
-        Entity* get() const { return ptr.get(); }
-        Entity& operator*() const { return *ptr; }
-        Entity* operator->() const { return ptr.get(); }
-
-        bool operator==(const EntityAllocator& other) const { return ptr == other.ptr; }
-        bool operator!=(const EntityAllocator& other) const { return ptr != other.ptr; }
-        bool operator==(const EntityReference& other) const { return other.get() == get(); }
-        bool operator!=(const EntityReference& other) const { return other.get() != get(); }
-
-        // Allow implicit conversion back to shared_ptr when needed
-        operator std::shared_ptr<Entity>&() { return ptr; }
-        operator const std::shared_ptr<Entity>&() const { return ptr; }
-        
-        // implicit conversion to EntityReference
-        operator EntityReference() const { return EntityReference(ptr); }
-
-        std::shared_ptr<Entity> getShared() const { return ptr; }
-
-        // <-- NEW: make it usable in if(entity) checks
-        explicit operator bool() const noexcept { return static_cast<bool>(ptr); }
-    };
-
-    // Collection (list of owners)
-    class EntityCollection {
-        std::list<EntityAllocator> entities;
-    public:
-        using iterator = std::list<EntityAllocator>::iterator;
-        using const_iterator = std::list<EntityAllocator>::const_iterator;
-
-        void add(EntityAllocator alloc) { entities.push_back(std::move(alloc)); }
-
-        // We only push allocators, since this is the owner container
-        void push_back(EntityAllocator alloc) {
-            entities.push_back(std::move(alloc));
-        }
-
-        iterator begin() { return entities.begin(); }
-        iterator end() { return entities.end(); }
-        const_iterator begin() const { return entities.begin(); }
-        const_iterator end() const { return entities.end(); }
-        
-        // expose erase (standard list erase)
-        iterator erase(iterator pos) { return entities.erase(pos); }
-        iterator erase(iterator first, iterator last) { return entities.erase(first, last); }
-
-        bool empty() const { return entities.empty(); }
-        size_t size() const { return entities.size(); }
-    };
-
     // Query result (vector of refs)
     class EntityQueryResult {
         std::vector<EntityReference> refs;
@@ -142,14 +192,12 @@ namespace ssge
             refs.push_back(ref);
         }
 
-        // Add from an EntityAllocator (convert to weak_ptr)
-        void push_back(const EntityAllocator& alloc) {
-            refs.push_back(EntityReference(alloc));
-        }
-
         // Optional: alias for "add" if you want consistency
         void add(const EntityReference& ref) { push_back(ref); }
 
+        void clear() { refs.clear(); }
+        void reserve(size_t count) { refs.reserve(count); }
+
         iterator begin() { return refs.begin(); }
         iterator end() { return refs.end(); }
         const_iterator begin() const { return refs.begin(); }
@@ -161,6 +209,76 @@ namespace ssge
         EntityReference operator[](size_t i) const { return refs[i]; }
     };
 
+    // Entities of one class, in the order they were added.
+    // live doesn't count the ones scheduled to be destroyed, members still
+    // lists them until they're actually gone.
+    struct EntityClassBucket {
+        std::vector<EntityHandle> members;
+        size_t live = 0;
+        bool dirty = false; // Has members to drop after destruction
+    };
+
+    // View of the live entities of one class. Walks only that class's
+    // bucket, skipping entities scheduled to be destroyed. Entities added
+    // after the view was made aren't visited. Don't keep views around:
+    // they are for walking right away.
+    class EntityClassView {
+        const EntitySlotMap* slots = nullptr;
+        const EntityClassBucket* bucket = nullptr;
+        size_t count = 0; // Members when the view was made
+
+    public:
+        class iterator {
+            const EntitySlotMap* slots;
+            const std::vector<EntityHandle>* members;
+            size_t position;
+            size_t count;
+
+            void skip() {
+                for (; position < count; position++) {
+                    Entity* entity = slots->resolve((*members)[position]);
+                    if (entity && !entity->isScheduledToDestroy())
+                        break;
+                }
+            }
+        public:
+            iterator(const EntitySlotMap* slots, const std::vector<EntityHandle>* members,
+                size_t position, size_t count)
+                : slots(slots), members(members), position(position), count(count) {
+                skip();
+            }
+
+            EntityReference operator*() const {
+                return EntityReference(*slots, (*members)[position]);
+            }
+            Entity* get() const { return slots->resolve((*members)[position]); }
+            iterator& operator++() { position++; skip(); return *this; }
+            bool operator==(const iterator& other) const { return position == other.position; }
+            bool operator!=(const iterator& other) const { return position != other.position; }
+        };
+
+        EntityClassView() = default;
+        EntityClassView(const EntitySlotMap& slots, const EntityClassBucket& bucket)
+            : slots(&slots), bucket(&bucket), count(bucket.members.size()) {}
+
+        iterator begin() const {
+            return bucket ? iterator(slots, &bucket->members, 0, count) : end();
+        }
+        iterator end() const {
+            return iterator(slots, bucket ? &bucket->members : nullptr, count, count);
+        }
+
+        // How many are live right now
+        size_t size() const { return bucket ? bucket->live : 0; }
+        bool empty() const { return size() == 0; }
+    };
+
+    // Two entities whose hitboxes overlap
+    struct EntityPair {
+        EntityReference first;
+        EntityReference second;
+    };
+
     // Forward declare GameWorld in order to allow only it to create EntityManager
 
     class GameWorld;
@@ -169,20 +287,125 @@ namespace ssge
 	{
     public: // Okay to make public. EntityManager is NEVER exposed to GAMEDEV
         EntityManager(PassKey<GameWorld> pk) {}; // Only GameWorld may create EntityManager
+        ~EntityManager();
 
         void step(GameWorldStepContext& context);
         void draw(DrawContext& context);
 
-        EntityCollection entities;
-        EntityCollection::iterator getEntitiesBegin();
-        EntityCollection::iterator getEntitiesEnd();
-        EntityReference addEntity(std::shared_ptr<Entity> entity);
+        EntitySlotMap entities;
+        EntitySlotMap::const_iterator getEntitiesBegin() const;
+        EntitySlotMap::const_iterator getEntitiesEnd() const;
+        EntityReference addEntity(std::unique_ptr<Entity> entity);
+        // Makes room for count entities (storage and their parts' pools)
+        void reserve(size_t count);
         bool scheduleDestroy(EntityReference entity);
-        Entity* findEntity(const std::string& entityClassID);
-        const Entity* findConstEntity(const std::string& entityClassID) const;
-        EntityQueryResult findAllEntities(const std::string& entityClassID);
+        Entity* findEntity(ClassID entityClassID);
+        const Entity* findConstEntity(ClassID entityClassID) const;
+        EntityClassView findAllEntities(ClassID entityClassID) const;
         int countAllEntities() const;
-        int countAllEntities(const std::string& entityClassID) const;
-        void destroyScheduledEntities(GameWorldStepContext& context);
+        int countAllEntities(ClassID entityClassID) const;
+        // Spawns and destroys during a tick are recorded, not carried out:
+        // spawned entities resolve right away but aren't stepped until the
+        // next tick, destroyed ones stay until the end of the tick. This
+        // runs every onDestroy, adds the spawns and removes the destroyed
+        // in one go. step() calls it last thing.
+        void applyCommands(GameWorldStepContext& context);
+        // Adds pending spawns without touching destroys (e.g. after loading)
+        void commitSpawns();
+        // Entity::destroy reports here, so live counts drop right away
+        void onScheduledToDestroy(PassKey<Entity> pk, Entity& entity, uint32_t slot);
+
+        // Feeds every entity, in order, into a state hash
+        void hashState(StateHash& hash) const;
+
+        // Spatial queries go by hitboxes in the world, as of each entity's
+        // last step (or its adding). Results live in buffers that the next
+        // query of the same kind reuses, so copy what has to outlive it.
+        // Entities scheduled to be destroyed are left out.
+
+        // Cells of the spatial hash, normally the level's block size
+        void setSpatialCellSize(float width, float height);
+        // Re-files every entity, for when they were moved outside of step()
+        void updateSpatialHash();
+        // Entities whose hitbox overlaps rect
+        const EntityQueryResult& queryRect(const SDL_FRect& rect);
+        // Entities whose hitbox is within radius of center
+        const EntityQueryResult& queryRadius(SDL_FPoint center, float radius);
+        // Every pair of entities with overlapping hitboxes, each pair once
+        const std::vector<EntityPair>& queryPairs();
+
+        // Only entities whose hitbox touches rect step. The rest are
+        // dormant: skipped, or stepped every dormantInterval ticks if that
+        // isn't 0. Entities on their first step and ones with alwaysActive
+        // set always step. GameWorld sets this around the view every tick.
+        void setActiveRect(const SDL_FRect& rect, uint32_t dormantInterval);
+        // Steps every entity again
+        void clearActiveRect();
+
+        // Times building a fresh EntityStepContext per entity against
+        // rebinding one per tick, and prints both per entity
+        void benchmarkStepContexts(GameWorldStepContext& context, int entityCount);
+
+    private:
+        // Activation (see setActiveRect)
+        bool activeRectSet = false;
+        SDL_FRect activeRect{ 0.f, 0.f, 0.f, 0.f };
+        uint32_t dormantInterval = 0;
+        uint32_t ticks = 0;
+        std::vector<uint32_t> awake; // Dense positions stepped this tick, ascending
+
+        bool isAwake(size_t position) const;
+
+        std::vector<EntityHandle> destroyQueue; // Scheduled this tick, in order
+        std::vector<size_t> destroyed;          // Scratch for applyCommands
+        PhysicsBatch physicsBatch;     // Velocity phase of all bodies
+        SpatialHash spatialHash;       // Hitboxes by slot index
+
+        // By ClassID index. A deque so views survive new classes showing up.
+        std::deque<EntityClassBucket> classes;
+        size_t live = 0; // All classes
+
+        EntityClassBucket* findClass(ClassID entityClassID);
+        const EntityClassBucket* findClass(ClassID entityClassID) const;
+
+        // Reused query buffers
+        std::vector<uint32_t> foundSlots;
+        std::vector<std::pair<uint32_t, uint32_t>> foundSlotPairs;
+        EntityQueryResult queryResult;
+        std::vector<EntityPair> pairResult;
+
+        void updateSpatialHash(size_t position);
+
+        // What draw() submits this frame: the on-screen entities, by
+        // layer, then spritesheet, then the order they were added in
+        struct DrawItem {
+            int layer;
+            uint32_t group; // Entity class index, same spritesheet in practice
+            uint32_t order;
+            const Entity* entity;
+            SDL_FPoint position; // Interpolated
+        };
+        std::vector<DrawItem> drawList;
+
+        // Second step halves (sweeps and postStep) of the awake entities,
+        // on every worker when there are workers. Each worker has its own
+        // step context and block write journal. Serial stepping takes the
+        // same path, so both modes end up bit for bit the same.
+        static const size_t END_STEP_GRAIN = 16; // Entities per chunk
+        std::vector<EntityStepContext> workerContexts;
+        std::vector<Level::WriteJournal> journals;
+        std::vector<Level::WriteJournal::Write> mergedWrites;
+        std::vector<uint8_t> destroyedInPhase; // By slot, while deferring
+        bool deferDestroys = false;
+
+        void stepSecondHalves(GameWorldStepContext& context);
+        // The pool to step on, null unless --jobs asked for it
+        static JobPool* stepJobs(GameWorldStepContext& context);
+        void reportDestroyed(EntityHandle handle, Entity& entity);
+        const EntityQueryResult& collectFound();
+
+        // Everything but the current entity, which step() rebinds
+        EntityStepContext makeStepContext(GameWorldStepContext& context);
+        void applyCommands(EntityStepContext& entityStepContext);
 	};
 }
\ No newline at end of file
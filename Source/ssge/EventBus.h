@@ -0,0 +1,151 @@
+#pragma once
+#include <SDL.h>
+#include <array>
+#include <functional>
+#include <tuple>
+#include <vector>
+#include <cstddef>
+
+namespace ssge
+{
+	class StepContext;
+
+	///////////////////////////////////
+	// Events the engine knows about //
+	///////////////////////////////////
+
+	// The user (or the OS) asked to close the program
+	struct QuitRequestedEvent {};
+
+	// A joypad or game controller was unplugged
+	struct JoypadUnpluggedEvent
+	{
+		SDL_JoystickID which = -1;
+	};
+
+	// SceneManager switched to a new scene (ask ScenesAccess which)
+	struct SceneChangedEvent {};
+
+	// The hero is gone for good
+	struct HeroDiedEvent {};
+
+	// The hero reached the victory block
+	struct VictoryEvent {};
+
+	// Settings were changed and should be written out
+	struct SaveSettingsEvent {};
+
+	// Fixed-capacity FIFO. Never allocates.
+	template<typename T, size_t CAPACITY>
+	class EventRing
+	{
+		std::array<T, CAPACITY> items{};
+		size_t head = 0;
+		size_t count = 0;
+	public:
+		bool push(const T& item)
+		{
+			if (count == CAPACITY)
+				return false;
+			items[(head + count) % CAPACITY] = item;
+			count++;
+			return true;
+		}
+		bool pop(T& item)
+		{
+			if (count == 0)
+				return false;
+			item = items[head];
+			head = (head + 1) % CAPACITY;
+			count--;
+			return true;
+		}
+		size_t size() const { return count; }
+	};
+
+	// Queues typed events and hands them to subscribers when drained.
+	//
+	// Each event type has its own ring, so posting never allocates.
+	// Engine drains the bus at fixed points of the tick. Types are
+	// delivered in the order they're listed, each type in posting order,
+	// so the outcome doesn't depend on who happened to post first.
+	// Events posted by subscribers wait for the next drain.
+	template<typename... Events>
+	class EventBusOf
+	{
+	public:
+		static const size_t CAPACITY = 16; // Per event type
+
+		template<typename T>
+		using Handler = std::function<void(const T&, StepContext&)>;
+
+	private:
+		template<typename T>
+		struct Channel
+		{
+			EventRing<T, CAPACITY> queued;
+			std::vector<Handler<T>> subscribers;
+			unsigned dropped = 0;
+		};
+
+		std::tuple<Channel<Events>...> channels;
+
+		template<typename T>
+		void drainChannel(Channel<T>& channel, StepContext& context)
+		{
+			// Only what's queued now, reposts go to the next drain
+			size_t pending = channel.queued.size();
+			T event;
+			while (pending-- && channel.queued.pop(event))
+			{
+				for (auto& handler : channel.subscribers)
+					handler(event, context);
+			}
+		}
+
+	public:
+		// Queues an event. Returns false if its ring is full.
+		template<typename T>
+		bool post(const T& event)
+		{
+			auto& channel = std::get<Channel<T>>(channels);
+			if (!channel.queued.push(event))
+			{
+				channel.dropped++;
+				return false;
+			}
+			return true;
+		}
+
+		// Subscribes for the lifetime of the bus (do it during init)
+		template<typename T>
+		void subscribe(Handler<T> handler)
+		{
+			std::get<Channel<T>>(channels).subscribers.push_back(std::move(handler));
+		}
+
+		// Events of type T lost to a full ring so far
+		template<typename T>
+		unsigned getDropped() const
+		{
+			return std::get<Channel<T>>(channels).dropped;
+		}
+
+		// Delivers everything queued so far
+		void drain(StepContext& context)
+		{
+			(drainChannel(std::get<Channel<Events>>(channels), context), ...);
+		}
+	};
+
+	// Delivery order is the order of this list
+	class EventBus : public EventBusOf<
+		QuitRequestedEvent,
+		JoypadUnpluggedEvent,
+		SceneChangedEvent,
+		HeroDiedEvent,
+		VictoryEvent,
+		SaveSettingsEvent>
+	{
+	};
+}
@@ -0,0 +1,111 @@
+#pragma once
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+
+// Runs physics in 16.16 fixed point. Pass -DSSGE_FIXED_PHYSICS=1 for
+// replays and lockstep comparisons that match bit for bit across
+// compilers, optimization levels and x87/SSE builds.
+#ifndef SSGE_FIXED_PHYSICS
+#define SSGE_FIXED_PHYSICS 0
+#endif
+
+namespace ssge
+{
+	// 16.16 fixed-point number. Everything but the float conversions is
+	// integer math, so results don't depend on the FPU or the compiler.
+	//
+	// Converting from float scales by 2^16 (exact) and rounds to nearest,
+	// so the same float always gives the same Fixed. Range is +-32767,
+	// converting anything outside of it wraps (debug builds assert).
+	class Fixed
+	{
+		int32_t raw = 0;
+
+	public:
+		static const int FRACTION_BITS = 16;
+		static const int32_t ONE = 1 << FRACTION_BITS;
+		static const int32_t MAX_INT = 32767; // Largest whole number it holds
+
+		constexpr Fixed() = default;
+		constexpr Fixed(int value) : raw(value * ONE)
+		{
+			assert(value >= -MAX_INT && value <= MAX_INT);
+		}
+		Fixed(float value) : raw((int32_t)std::lround(value * (float)ONE))
+		{
+			assert(std::fabs(value) < (float)(MAX_INT + 1));
+		}
+		Fixed(double value) : raw((int32_t)std::lround(value * (double)ONE))
+		{
+			assert(std::fabs(value) < (double)(MAX_INT + 1));
+		}
+
+		static constexpr Fixed fromRaw(int32_t raw) { Fixed f; f.raw = raw; return f; }
+		constexpr int32_t getRaw() const { return raw; }
+
+		float toFloat() const { return (float)raw / (float)ONE; }
+		explicit operator float() const { return toFloat(); }
+
+		// Rounds toward -infinity
+		constexpr int floorToInt() const { return raw >> FRACTION_BITS; }
+		constexpr Fixed floor() const { return fromRaw(raw & ~(ONE - 1)); }
+
+		// Smallest step there is
+		static constexpr Fixed epsilon() { return fromRaw(1); }
+
+		constexpr Fixed operator-() const { return fromRaw(-raw); }
+
+		friend constexpr Fixed operator+(Fixed a, Fixed b) { return fromRaw(a.raw + b.raw); }
+		friend constexpr Fixed operator-(Fixed a, Fixed b) { return fromRaw(a.raw - b.raw); }
+		friend constexpr Fixed operator*(Fixed a, Fixed b)
+		{
+			return fromRaw((int32_t)(((int64_t)a.raw * b.raw) >> FRACTION_BITS));
+		}
+		friend constexpr Fixed operator/(Fixed a, Fixed b)
+		{
+			return fromRaw((int32_t)(((int64_t)a.raw * ONE) / b.raw));
+		}
+
+		Fixed& operator+=(Fixed other) { raw += other.raw; return *this; }
+		Fixed& operator-=(Fixed other) { raw -= other.raw; return *this; }
+		Fixed& operator*=(Fixed other) { return *this = *this * other; }
+
+		friend constexpr bool operator==(Fixed a, Fixed b) { return a.raw == b.raw; }
+		friend constexpr bool operator!=(Fixed a, Fixed b) { return a.raw != b.raw; }
+		friend constexpr bool operator<(Fixed a, Fixed b) { return a.raw < b.raw; }
+		friend constexpr bool operator>(Fixed a, Fixed b) { return a.raw > b.raw; }
+		friend constexpr bool operator<=(Fixed a, Fixed b) { return a.raw <= b.raw; }
+		friend constexpr bool operator>=(Fixed a, Fixed b) { return a.raw >= b.raw; }
+	};
+
+	// What physics runs on: position, velocity and abilities while
+	// stepping, and the Level sweeps. Game code keeps seeing floats.
+	// With Fixed, world coordinates have to stay within +-32767 pixels
+	// (Fixed::MAX_INT), so Level::Loader refuses bigger levels.
+#if SSGE_FIXED_PHYSICS
+	using PhysicsReal = Fixed;
+#else
+	using PhysicsReal = float;
+#endif
+
+	// The same operations for both, so physics code reads the same
+
+	static inline float toFloat(float x) { return x; }
+	static inline float toFloat(Fixed x) { return x.toFloat(); }
+
+	static inline float floorOf(float x) { return std::floor(x); }
+	static inline Fixed floorOf(Fixed x) { return x.floor(); }
+
+	static inline float absOf(float x) { return std::fabs(x); }
+	static inline Fixed absOf(Fixed x) { return x < Fixed() ? -x : x; }
+
+	// Which cell of size cells x falls into, rounding toward -infinity
+	static inline int cellOf(float x, int size) { return (int)std::floor(x / (float)size); }
+	static inline int cellOf(Fixed x, int size)
+	{
+		int64_t cellSize = (int64_t)size * Fixed::ONE;
+		int64_t raw = x.getRaw();
+		return (int)(raw >= 0 ? raw / cellSize : -((-raw + cellSize - 1) / cellSize));
+	}
+}
@@ -0,0 +1,278 @@
+#include "FramePacer.h"
+#include <cmath>
+#include <iostream>
+
+using namespace ssge;
+
+FramePacer::FramePacer(int tickRate, int frameRate)
+{
+	frequency = SDL_GetPerformanceFrequency();
+	if (frequency == 0) frequency = 1; // Shouldn't happen, but no div by 0
+
+	setTickRate(tickRate);
+	setFrameRate(frameRate);
+	reset();
+}
+
+uint64_t FramePacer::now() const
+{
+	return SDL_GetPerformanceCounter();
+}
+
+uint64_t FramePacer::toMicroseconds(uint64_t counterTicks) const
+{
+	// Split to avoid overflowing on high frequency counters
+	return (counterTicks / frequency) * MICROSECONDS
+		+ (counterTicks % frequency) * MICROSECONDS / frequency;
+}
+
+void FramePacer::reset()
+{
+	accumulator = 0;
+	postponedTicks = 0;
+	lastAdvance = now();
+	nextFrameDeadline = 0;
+	lastFrameEnd = 0;
+}
+
+int FramePacer::getTickRate() const
+{
+	return tickRate;
+}
+
+void FramePacer::setTickRate(int tickRate)
+{
+	if (tickRate < 1) tickRate = 1;
+	this->tickRate = tickRate;
+}
+
+double FramePacer::getTickDelta() const
+{
+	return 1.0 / (double)tickRate;
+}
+
+int FramePacer::getFrameRate() const
+{
+	return frameRate;
+}
+
+void FramePacer::setFrameRate(int frameRate)
+{
+	if (frameRate < 0) frameRate = 0;
+	this->frameRate = frameRate;
+	nextFrameDeadline = 0;
+}
+
+void FramePacer::setMaxTicksPerFrame(unsigned maxTicks)
+{
+	maxTicksPerFrame = maxTicks ? maxTicks : 1;
+}
+
+unsigned FramePacer::advance()
+{
+	uint64_t current = now();
+	uint64_t elapsedUS = toMicroseconds(current - lastAdvance);
+	lastAdvance = current;
+
+	// Clamp huge stalls (alt-tab, breakpoint, etc.)
+	if (elapsedUS > maxFrameTimeUS) elapsedUS = maxFrameTimeUS;
+
+	accumulator += elapsedUS * (uint64_t)tickRate;
+
+	uint64_t due = accumulator / MICROSECONDS;
+
+	// Prevent spiral of deadth by limiting frameskip.
+	// The rest stays accumulated and gets caught up on later.
+	// Only count ticks that weren't already over the cap last time.
+	uint64_t postponed = due > maxTicksPerFrame ? due - maxTicksPerFrame : 0;
+	if (postponed > postponedTicks)
+		droppedTicks += postponed - postponedTicks;
+	postponedTicks = postponed;
+	if (postponed)
+		due = maxTicksPerFrame;
+
+	return (unsigned)due;
+}
+
+void FramePacer::consumeTick()
+{
+	if (accumulator >= MICROSECONDS)
+		accumulator -= MICROSECONDS;
+	else
+		accumulator = 0;
+}
+
+bool FramePacer::isTickDue() const
+{
+	return accumulator >= MICROSECONDS;
+}
+
+float FramePacer::getInterpolation() const
+{
+	if (accumulator >= MICROSECONDS)
+		return 1.0f;
+	return (float)accumulator / (float)MICROSECONDS;
+}
+
+void FramePacer::waitUntil(uint64_t deadline)
+{
+	for (;;)
+	{
+		uint64_t current = now();
+		if (current >= deadline)
+			break;
+
+		uint64_t remainingUS = toMicroseconds(deadline - current);
+		if (remainingUS > spinThresholdUS)
+		{ // Sleep through the bulk of it
+			Uint32 sleepMS = (Uint32)((remainingUS - spinThresholdUS) / 1000);
+			if (sleepMS < 1) sleepMS = 1;
+
+			SDL_Delay(sleepMS);
+
+			// Learn how badly this system oversleeps and spin that long
+			uint64_t sleptUS = toMicroseconds(now() - current);
+			uint64_t wantedUS = (uint64_t)sleepMS * 1000;
+			uint64_t overshootUS = sleptUS > wantedUS ? sleptUS - wantedUS : 0;
+			uint64_t wantedThreshold = overshootUS + 250;
+			if (wantedThreshold > 4000) wantedThreshold = 4000;
+
+			if (wantedThreshold > spinThresholdUS)
+				spinThresholdUS = wantedThreshold; // Be careful right away
+			else
+				spinThresholdUS -= (spinThresholdUS - wantedThreshold) / 16; // Relax slowly
+
+			if (spinThresholdUS < 500) spinThresholdUS = 500;
+		}
+		// Otherwise spin for the last stretch
+	}
+}
+
+void FramePacer::recordFrameInterval(uint64_t end)
+{
+	if (lastFrameEnd)
+	{
+		double intervalUS = (double)toMicroseconds(end - lastFrameEnd);
+
+		if (intervalCount == 0 || intervalUS < intervalMin) intervalMin = intervalUS;
+		if (intervalCount == 0 || intervalUS > intervalMax) intervalMax = intervalUS;
+		intervalSum += intervalUS;
+		intervalSquaresSum += intervalUS * intervalUS;
+		intervalCount++;
+	}
+	lastFrameEnd = end;
+}
+
+void FramePacer::waitForNextFrame()
+{
+	if (frameRate > 0)
+	{
+		const uint64_t period = frequency / (uint64_t)frameRate;
+		uint64_t current = now();
+
+		if (nextFrameDeadline == 0 || current > nextFrameDeadline + period)
+		{ // First frame, or we fell over a whole frame behind. Resync.
+			nextFrameDeadline = current + period;
+		}
+		else
+		{
+			waitUntil(nextFrameDeadline);
+
+			double wakeErrorUS = (double)toMicroseconds(now() - nextFrameDeadline);
+			wakeErrorSum += wakeErrorUS;
+			if (wakeErrorUS > wakeErrorMax) wakeErrorMax = wakeErrorUS;
+			if (wakeErrorUS > 1000.0) lateCount++;
+			wakeCount++;
+
+			nextFrameDeadline += period;
+		}
+	}
+
+	recordFrameInterval(now());
+}
+
+void FramePacer::waitForNextTick(uint64_t maxWaitUS)
+{
+	uint64_t current = now();
+	uint64_t pending = accumulator
+		+ toMicroseconds(current - lastAdvance) * (uint64_t)tickRate;
+	if (pending >= MICROSECONDS)
+		return;
+
+	uint64_t waitUS = (MICROSECONDS - pending + tickRate - 1) / (uint64_t)tickRate;
+	if (waitUS > maxWaitUS) waitUS = maxWaitUS;
+
+	waitUntil(current + waitUS * frequency / MICROSECONDS);
+}
+
+FramePacer::Statistics FramePacer::getStatistics() const
+{
+	Statistics statistics;
+
+	statistics.frames = intervalCount;
+	if (intervalCount)
+	{
+		double mean = intervalSum / (double)intervalCount;
+		double variance = intervalSquaresSum / (double)intervalCount - mean * mean;
+		statistics.meanIntervalUS = mean;
+		statistics.jitterUS = variance > 0 ? std::sqrt(variance) : 0;
+		statistics.minIntervalUS = intervalMin;
+		statistics.maxIntervalUS = intervalMax;
+	}
+
+	statistics.pacedFrames = wakeCount;
+	if (wakeCount)
+	{
+		statistics.meanWakeErrorUS = wakeErrorSum / (double)wakeCount;
+		statistics.maxWakeErrorUS = wakeErrorMax;
+	}
+	statistics.lateFrames = lateCount;
+	statistics.droppedTicks = droppedTicks;
+
+	return statistics;
+}
+
+void FramePacer::resetStatistics()
+{
+	intervalCount = 0;
+	intervalSum = 0;
+	intervalSquaresSum = 0;
+	intervalMin = 0;
+	intervalMax = 0;
+	wakeCount = 0;
+	wakeErrorSum = 0;
+	wakeErrorMax = 0;
+	lateCount = 0;
+	droppedTicks = 0;
+}
+
+void FramePacer::printStatistics(const char* title) const
+{
+	Statistics s = getStatistics();
+
+	std::cout << title << ": " << s.frames << " frames, "
+		<< tickRate << " Hz ticks, frame cap ";
+	if (frameRate) std::cout << frameRate << " Hz";
+	else std::cout << "none";
+	std::cout << std::endl;
+
+	if (s.frames)
+	{
+		std::cout << "  frame interval: mean " << s.meanIntervalUS
+			<< " us, jitter " << s.jitterUS
+			<< " us, min " << s.minIntervalUS
+			<< " us, max " << s.maxIntervalUS << " us" << std::endl;
+	}
+	if (s.pacedFrames)
+	{
+		std::cout << "  wake error: mean " << s.meanWakeErrorUS
+			<< " us, max " << s.maxWakeErrorUS
+			<< " us, late (>1 ms) " << s.lateFrames
+			<< " of " << s.pacedFrames << std::endl;
+	}
+	if (s.droppedTicks)
+	{
+		std::cout << "  ticks deferred by frameskip cap: " << s.droppedTicks
+			<< std::endl;
+	}
+}
@@ -0,0 +1,112 @@
+#pragma once
+#include <SDL.h>
+#include <cstdint>
+
+namespace ssge
+{
+	// Keeps the fixed simulation rate and the frame rate in check using
+	// SDL's high resolution performance counter.
+	//
+	// Ticks: time is accumulated in microseconds (scaled by the tick rate,
+	// so 60 Hz really is 60 Hz instead of 1000/17). advance() tells how
+	// many ticks are due, getInterpolation() how far we are into the next.
+	//
+	// Frames: with a frame rate cap (vsync off), waitForNextFrame() sleeps
+	// most of the remaining time and spins the last stretch, because
+	// SDL_Delay alone oversleeps by a millisecond or more on many systems.
+	class FramePacer
+	{
+	public:
+		struct Statistics
+		{
+			uint64_t frames = 0;          // Frames measured
+			double meanIntervalUS = 0;    // Average frame-to-frame time
+			double jitterUS = 0;          // Standard deviation of the above
+			double minIntervalUS = 0;
+			double maxIntervalUS = 0;
+			uint64_t pacedFrames = 0;     // Frames that waited for a deadline
+			double meanWakeErrorUS = 0;   // How late we woke up on average
+			double maxWakeErrorUS = 0;    // Worst wake-up
+			uint64_t lateFrames = 0;      // Woke up over a millisecond late
+			uint64_t droppedTicks = 0;    // Ticks postponed by the frameskip cap
+		};
+
+	private:
+		static const uint64_t MICROSECONDS = 1000000;
+
+		uint64_t frequency = 1;      // Performance counter ticks per second
+		int tickRate = 60;           // Simulation ticks per second
+		int frameRate = 0;           // Frame cap, 0 = no cap (vsync paces)
+		unsigned maxTicksPerFrame = 5;
+		uint64_t maxFrameTimeUS = 250000; // Clamp for huge stalls
+
+		// Microseconds multiplied by tickRate. One tick = MICROSECONDS.
+		uint64_t accumulator = 0;
+		uint64_t lastAdvance = 0;
+
+		uint64_t nextFrameDeadline = 0;
+		uint64_t lastFrameEnd = 0;
+
+		// Worst recent oversleep of SDL_Delay, spin for at least this long
+		uint64_t spinThresholdUS = 2000;
+
+		// Running sums for statistics
+		uint64_t intervalCount = 0;
+		double intervalSum = 0;
+		double intervalSquaresSum = 0;
+		double intervalMin = 0;
+		double intervalMax = 0;
+		uint64_t wakeCount = 0;
+		double wakeErrorSum = 0;
+		double wakeErrorMax = 0;
+		uint64_t lateCount = 0;
+		uint64_t droppedTicks = 0;
+		uint64_t postponedTicks = 0; // Over the cap at the last advance
+
+		uint64_t now() const;
+		uint64_t toMicroseconds(uint64_t counterTicks) const;
+		void waitUntil(uint64_t deadline);
+		void recordFrameInterval(uint64_t end);
+
+	public:
+		FramePacer(int tickRate = 60, int frameRate = 0);
+
+		// Starts measuring from now and forgets accumulated time
+		void reset();
+
+		int getTickRate() const;
+		void setTickRate(int tickRate);
+		// Fixed delta time of one tick in seconds
+		double getTickDelta() const;
+
+		int getFrameRate() const;
+		// Caps frames per second. 0 = no cap (let vsync do the pacing).
+		void setFrameRate(int frameRate);
+
+		// Frameskip cap (prevents the spiral of deadth)
+		void setMaxTicksPerFrame(unsigned maxTicks);
+
+		// Accumulates the time passed since the last call.
+		// Returns how many ticks are due now. Call consumeTick() after each.
+		unsigned advance();
+		void consumeTick();
+		// True if a whole tick's worth of time is accumulated
+		bool isTickDue() const;
+
+		// 0..1, how far we are between the last tick and the next
+		float getInterpolation() const;
+
+		// Ends the frame. With a frame cap, waits for the next frame's
+		// deadline using sleep-then-spin. Without one, only measures.
+		void waitForNextFrame();
+
+		// Waits until the next tick is due, but at most maxWaitUS.
+		// For loops that only simulate and have nothing else to do.
+		void waitForNextTick(uint64_t maxWaitUS);
+
+		Statistics getStatistics() const;
+		void resetStatistics();
+		// Prints the statistics to std::cout
+		void printStatistics(const char* title) const;
+	};
+}
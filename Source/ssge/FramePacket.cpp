@@ -0,0 +1,234 @@
+#include "FramePacket.h"
+#include "RenderBatch.h"
+
+using namespace ssge;
+
+void FramePacket::clear()
+{
+	commands.clear();
+	textsUsed = 0; // Strings stay allocated for reuse
+}
+
+size_t FramePacket::size() const
+{
+	return commands.size();
+}
+
+bool FramePacket::empty() const
+{
+	return commands.empty();
+}
+
+void FramePacket::fillRect(const SDL_Rect& rect, SDL_Color color)
+{
+	Command command;
+	command.kind = Command::Kind::FillRect;
+	command.dst = rect;
+	command.hasDst = true;
+	command.color = color;
+	commands.push_back(command);
+}
+
+void FramePacket::copy(SDL_Texture* texture, const SDL_Rect* src, const SDL_Rect* dst)
+{
+	if (!texture)
+		return;
+
+	Command command;
+	command.kind = Command::Kind::Copy;
+	command.texture = texture;
+	if (src) { command.src = *src; command.hasSrc = true; }
+	if (dst) { command.dst = *dst; command.hasDst = true; }
+	commands.push_back(command);
+}
+
+void FramePacket::copyEx(SDL_Texture* texture, const SDL_Rect* src, const SDL_Rect* dst,
+	double angle, const SDL_Point* center, SDL_RendererFlip flip, Uint8 alpha)
+{
+	if (!texture)
+		return;
+
+	Command command;
+	command.kind = Command::Kind::CopyEx;
+	command.texture = texture;
+	if (src) { command.src = *src; command.hasSrc = true; }
+	if (dst) { command.dst = *dst; command.hasDst = true; }
+	command.angle = angle;
+	if (center) { command.center = *center; command.hasCenter = true; }
+	command.flip = flip;
+	command.alpha = alpha;
+	commands.push_back(command);
+}
+
+void FramePacket::drawTextCentered(TTF_Font* font, const std::string& text,
+	int xCenter, int y, SDL_Color color, SDL_Color shadowColor, int shadowOffset)
+{
+	addText(font, text, xCenter, y, true, color, shadowColor, shadowOffset);
+}
+
+void FramePacket::drawText(TTF_Font* font, const std::string& text,
+	int x, int y, SDL_Color color, SDL_Color shadowColor, int shadowOffset)
+{
+	addText(font, text, x, y, false, color, shadowColor, shadowOffset);
+}
+
+void FramePacket::addText(TTF_Font* font, const std::string& text,
+	int x, int y, bool centered, SDL_Color color,
+	SDL_Color shadowColor, int shadowOffset)
+{
+	if (!font)
+		return;
+
+	// Reuse a previously allocated string if we have one
+	if (textsUsed == texts.size())
+		texts.emplace_back();
+	texts[textsUsed] = text;
+
+	Command command;
+	command.kind = Command::Kind::Text;
+	command.font = font;
+	command.dst = SDL_Rect{ x, y, 0, 0 };
+	command.centered = centered;
+	command.color = color;
+	command.shadowColor = shadowColor;
+	command.shadowOffset = shadowOffset;
+	command.textIndex = textsUsed++;
+	commands.push_back(command);
+}
+
+void FramePacket::replay(SDL_Renderer* renderer, RenderBatch& batch) const
+{
+	batch.begin(renderer);
+
+	for (const auto& command : commands)
+	{
+		if (batch.add(command))
+			continue; // Drawn with the batch
+
+		// Whatever was batched goes first
+		batch.flush();
+
+		const char* text = nullptr;
+		if (command.kind == Command::Kind::Text)
+			text = texts[command.textIndex].c_str();
+
+		batch.countDrawCalls(execute(renderer, command, text));
+	}
+
+	batch.flush();
+}
+
+int FramePacket::execute(SDL_Renderer* renderer, const Command& command, const char* text)
+{
+	if (!renderer)
+		return 0;
+
+	int calls = 1;
+
+	const SDL_Rect* src = command.hasSrc ? &command.src : nullptr;
+	const SDL_Rect* dst = command.hasDst ? &command.dst : nullptr;
+
+	switch (command.kind)
+	{
+	case Command::Kind::FillRect:
+		SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+		SDL_SetRenderDrawColor(renderer,
+			command.color.r, command.color.g, command.color.b, command.color.a);
+		SDL_RenderFillRect(renderer, dst);
+		break;
+	case Command::Kind::Copy:
+		SDL_RenderCopy(renderer, command.texture, src, dst);
+		break;
+	case Command::Kind::CopyEx:
+	{
+		// Update TextureAlphaMod, but only if we changed it
+		Uint8 alphaInSDL;
+		SDL_GetTextureAlphaMod(command.texture, &alphaInSDL);
+		if (command.alpha != alphaInSDL)
+			SDL_SetTextureAlphaMod(command.texture, command.alpha);
+
+		SDL_RenderCopyEx(renderer, command.texture, src, dst, command.angle,
+			command.hasCenter ? &command.center : nullptr, command.flip);
+		break;
+	}
+	case Command::Kind::Text:
+	{
+		calls = 0;
+		if (!command.font || !text)
+			break;
+
+		// Measure first to compute the centered x
+		int w = 0, h = 0;
+		if (TTF_SizeUTF8(command.font, text, &w, &h) != 0)
+			break; // If measure fails, bail gracefully
+		int x = command.centered ? command.dst.x - (w / 2) : command.dst.x;
+		int y = command.dst.y;
+
+		// Small lambda to render one colored copy
+		auto renderOnce = [&](SDL_Color c, int dx, int dy) {
+			SDL_Surface* srf = TTF_RenderUTF8_Blended(command.font, text, c);
+			if (!srf) return;
+			SDL_Texture* tex = SDL_CreateTextureFromSurface(renderer, srf);
+			SDL_FreeSurface(srf);
+			if (!tex) return;
+			SDL_Rect textDst{ x + dx, y + dy, w, h };
+			SDL_RenderCopy(renderer, tex, nullptr, &textDst);
+			SDL_DestroyTexture(tex);
+			calls++;
+			};
+
+		if (command.shadowOffset)
+			renderOnce(command.shadowColor, command.shadowOffset, command.shadowOffset);
+		renderOnce(command.color, 0, 0);
+		break;
+	}
+	}
+
+	return calls;
+}
+
+FramePacketExchange::FramePacketExchange()
+{
+	SDL_AtomicSet(&middle, 1);
+}
+
+FramePacket& FramePacketExchange::beginWrite()
+{
+	FramePacket& packet = packets[writeIndex];
+	packet.clear();
+	return packet;
+}
+
+uint32_t FramePacketExchange::publish()
+{
+	uint32_t sequence = nextSequence++;
+	packets[writeIndex].sequence = sequence;
+
+	// Swap our slot into the middle, marked fresh, and take the old middle.
+	// SDL_AtomicSet is a full barrier, so the packet contents are visible
+	// to the reader before the index is.
+	writeIndex = SDL_AtomicSet(&middle, writeIndex | FRESH) & ~FRESH;
+
+	return sequence;
+}
+
+bool FramePacketExchange::isPending()
+{
+	return (SDL_AtomicGet(&middle) & FRESH) != 0;
+}
+
+const FramePacket* FramePacketExchange::acquireLatest()
+{
+	if (!(SDL_AtomicGet(&middle) & FRESH))
+		return nullptr;
+
+	// Swap our slot into the middle (not fresh) and take the fresh one
+	readIndex = SDL_AtomicSet(&middle, readIndex) & ~FRESH;
+
+	return &packets[readIndex];
+}
+
+const FramePacket& FramePacketExchange::current() const
+{
+	return packets[readIndex];
+}
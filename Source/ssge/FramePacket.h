@@ -0,0 +1,127 @@
+#pragma once
+#include <SDL.h>
+#include <SDL_ttf.h>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+namespace ssge
+{
+	class RenderBatch;
+
+	// A recorded frame: everything the scenes and menus wanted to draw,
+	// in order, without touching the SDL_Renderer.
+	// The simulation thread records it, the render thread replays it.
+	// Storage is kept between frames so recording doesn't allocate
+	// once the packet has grown to its working size.
+	class FramePacket
+	{
+	public:
+		struct Command
+		{
+			enum class Kind : uint8_t
+			{
+				FillRect,
+				Copy,
+				CopyEx,
+				Text
+			};
+
+			Kind kind = Kind::FillRect;
+			SDL_Texture* texture = nullptr;
+			SDL_Rect src = { 0,0,0,0 };
+			SDL_Rect dst = { 0,0,0,0 };
+			bool hasSrc = false;
+			bool hasDst = false;
+			// CopyEx
+			double angle = 0;
+			SDL_Point center = { 0,0 };
+			bool hasCenter = false;
+			SDL_RendererFlip flip = SDL_FLIP_NONE;
+			Uint8 alpha = 255;
+			// FillRect and Text
+			SDL_Color color = { 0,0,0,0 };
+			// Text (dst.x is the horizontal center or the left, dst.y the top)
+			TTF_Font* font = nullptr;
+			bool centered = true;
+			SDL_Color shadowColor = { 0,0,0,0 };
+			int shadowOffset = 0;
+			size_t textIndex = 0;
+		};
+
+	private:
+		std::vector<Command> commands;
+		std::vector<std::string> texts;
+		size_t textsUsed = 0;
+
+		void addText(TTF_Font* font, const std::string& text,
+			int x, int y, bool centered, SDL_Color color,
+			SDL_Color shadowColor, int shadowOffset);
+
+	public:
+		// Increases with every published packet. 0 = never published.
+		uint32_t sequence = 0;
+
+		// Forgets all commands but keeps the storage
+		void clear();
+		size_t size() const;
+		bool empty() const;
+
+		void fillRect(const SDL_Rect& rect, SDL_Color color);
+		void copy(SDL_Texture* texture, const SDL_Rect* src, const SDL_Rect* dst);
+		void copyEx(SDL_Texture* texture, const SDL_Rect* src, const SDL_Rect* dst,
+			double angle, const SDL_Point* center, SDL_RendererFlip flip,
+			Uint8 alpha);
+		void drawTextCentered(TTF_Font* font, const std::string& text,
+			int xCenter, int y, SDL_Color color,
+			SDL_Color shadowColor, int shadowOffset);
+		void drawText(TTF_Font* font, const std::string& text,
+			int x, int y, SDL_Color color,
+			SDL_Color shadowColor, int shadowOffset);
+
+		// Issues all recorded commands to the renderer, copies batched
+		// by batch (which also counts the calls).
+		// Must be called from the thread that owns the renderer!
+		void replay(SDL_Renderer* renderer, RenderBatch& batch) const;
+
+		// Issues a single command right away.
+		// This is what DrawContext uses when it isn't recording.
+		// Returns how many renderer calls it took.
+		static int execute(SDL_Renderer* renderer, const Command& command,
+			const char* text = nullptr);
+	};
+
+	// Lock-free triple buffer of FramePackets.
+	// Exactly one writer thread and one reader thread.
+	// The writer always has a packet to record into, the reader always has
+	// the latest complete packet, and neither ever waits on the other.
+	class FramePacketExchange
+	{
+		static const int FRESH = 4; // Flag bit next to the slot index
+
+		FramePacket packets[3];
+		SDL_atomic_t middle; // Slot index handed over between threads
+		int writeIndex = 0;  // Owned by the writer
+		int readIndex = 2;   // Owned by the reader
+		uint32_t nextSequence = 1;
+
+	public:
+		FramePacketExchange();
+		FramePacketExchange(const FramePacketExchange& toCopy) = delete;
+		FramePacketExchange(FramePacketExchange&& toMove) = delete;
+
+		// Writer: the packet to record the next frame into (cleared)
+		FramePacket& beginWrite();
+		// Writer: hands the recorded packet over to the reader.
+		// Returns its sequence number.
+		uint32_t publish();
+		// Writer: true if the reader hasn't picked up the last packet yet
+		bool isPending();
+
+		// Reader: picks up the latest packet if there is a new one.
+		// Returns nullptr if nothing new was published since the last call.
+		const FramePacket* acquireLatest();
+		// Reader: the packet acquired last
+		const FramePacket& current() const;
+	};
+}
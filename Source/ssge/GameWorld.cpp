@@ -3,7 +3,10 @@
 #include "DrawContext.h"
 #include "PassKey.h"
 #include "Accessor.h"
+#include "EngineOptions.h"
+#include "Utilities.h"
 #include <algorithm>
+#include <cstdio>
 
 using namespace ssge;
 
@@ -23,7 +26,10 @@ bool GameWorld::initLevel(SceneStepContext& context)
         }
         else
         {
-            lvl->loadTextures(context.drawing.getRenderer());
+            // Decoding fans out over the workers, uploading
+            // textures waits for it on the main (render) thread
+            JobPool& jobs = *context.engine.getJobs();
+            jobs.wait(lvl->submitTextureLoading(jobs, context.drawing.getRenderer()));
             auto musicPath = lvl->getMusicPath();
             if (!musicPath.empty())
             {
@@ -59,10 +65,12 @@ GameWorld::GameWorld(int wantedLevel) :
     this->wantedLevel = wantedLevel;
 }
 
+const ClassID GameWorld::classID("GameWorld");
+
 GameWorld* GameWorld::tryCast(Scene* scene)
 {
-    if (scene->getSceneClassID() != "GameWorld")
-        return dynamic_cast<GameWorld*>(scene);
+    if (scene && scene->getSceneClassID() == classID)
+        return static_cast<GameWorld*>(scene);
     else return nullptr;
 }
 
@@ -71,11 +79,6 @@ Scene& GameWorld::getAsScene()
     return *this;
 }
 
-void GameWorld::reportHeroDeadth()
-{
-    heroDied = true;
-}
-
 bool GameWorld::isGameplayOver() const
 {
 	return false;
@@ -106,9 +109,9 @@ void GameWorld::setConfines(SDL_FRect confines)
 	this->confines = confines;
 }
 
-std::string GameWorld::getSceneClassID() const
+ClassID GameWorld::getSceneClassID() const
 {
-    return "GameWorld";
+    return classID;
 }
 
 void GameWorld::init(SceneStepContext& context)
@@ -127,29 +130,144 @@ void GameWorld::init(SceneStepContext& context)
     {
         auto& spawnList = levelLoader.getSpawnList();
 
-        int currentEntityIndex = 0;
-        for (const auto& spawnEntry : spawnList)
-        {
-            // FIXME: BIG BODGE!
-            EntitiesAccess bodge(&entities, context.game);
-            EntityReference entity = bodge.addEntity(spawnEntry.what);
-            if (!entity)
-                continue;
+        // FIXME: BIG BODGE!
+        EntitiesAccess bodge(&entities, context.game);
 
-            entity->position = spawnEntry.where;
+        { // Size the pools up front so spawning during play doesn't allocate
+            std::vector<size_t> counts(ClassID::count() + 1, 0);
+            for (const auto& spawnEntry : spawnList)
+                counts[spawnEntry.what.getIndex()]++;
 
-            if (levelLoader.getHeroIndex() == currentEntityIndex)
+            size_t expected = 0;
+            for (const auto& spawnEntry : spawnList)
             {
-                heroEntity = entity;
+                size_t& count = counts[spawnEntry.what.getIndex()];
+                if (count && spawnEntry.what)
+                    expected += bodge.reserveEntities(spawnEntry.what, count);
+                count = 0; // Once per class
             }
+            entities.reserve(expected);
+        }
+
+        // Entity proximity goes by the level's block grid
+        entities.setSpatialCellSize((float)level->blockSize.w, (float)level->blockSize.h);
 
-            currentEntityIndex++;
+        // The hero and the always active ones right away, the rest once
+        // the view comes near (everything if the level says so)
+        unspawned.clear();
+        for (size_t i = 0; i < spawnList.size(); i++)
+        {
+            const auto& spawnEntry = spawnList[i];
+            if ((int)i == levelLoader.getHeroIndex() || spawnEntry.alwaysActive || !level->activation.enabled)
+                spawn(context, i);
+            else
+                unspawned.push_back(i);
         }
+        std::stable_sort(unspawned.begin(), unspawned.end(), [&](size_t a, size_t b) {
+            return spawnList[a].where.x < spawnList[b].where.x;
+        });
+
+        // Start off looking at the hero without sliding in from (0,0)
+        if (heroEntity)
+        {
+            auto e = heroEntity.get();
+            scrollTarget = e->position;
+            previousScrollTarget = scrollTarget;
+        }
+
+        // What the hero starts out seeing
+        activate(context);
+
+        // The level's entities step from the first tick on
+        entities.commitSpawns();
+
+        // Spawns were filed before they were put in place
+        entities.updateSpatialHash();
     }
 }
 
+bool GameWorld::spawn(SceneStepContext& context, size_t spawnIndex)
+{
+    const auto& spawnEntry = levelLoader.getSpawnList()[spawnIndex];
+
+    // FIXME: BIG BODGE!
+    EntitiesAccess bodge(&entities, context.game);
+
+    EntityReference entity = bodge.addEntity(spawnEntry.what);
+    if (!entity)
+        return false;
+
+    entity->position = spawnEntry.where;
+    entity->snapInterpolation();
+    if (spawnEntry.alwaysActive)
+        entity->alwaysActive = true;
+
+    if ((int)spawnIndex == levelLoader.getHeroIndex())
+    {
+        heroEntity = entity;
+        entity->alwaysActive = true;
+    }
+
+    return true;
+}
+
+void GameWorld::activate(SceneStepContext& context)
+{
+    if (!level || !level->activation.enabled)
+    {
+        entities.clearActiveRect();
+        return;
+    }
+
+    const Level::Activation& activation = level->activation;
+    SDL_Rect screenSize{ 0, 0, context.game.get().getVirtualWidth(), context.game.get().getVirtualHeight() };
+    SDL_Point viewOffset = calculateViewOffset(screenSize, scrollTarget);
+
+    // The view grown by margin screens on every side
+    auto around = [&](float margin) {
+        float w = screenSize.w * margin;
+        float h = screenSize.h * margin;
+        return SDL_FRect{ viewOffset.x - w, viewOffset.y - h, screenSize.w + w * 2.f, screenSize.h + h * 2.f };
+    };
+
+    // Spawns that came into range, in spawn list order
+    SDL_FRect spawnRect = around(activation.spawnMargin);
+    const auto& spawnList = levelLoader.getSpawnList();
+    auto first = std::lower_bound(unspawned.begin(), unspawned.end(), spawnRect.x,
+        [&](size_t index, float x) { return spawnList[index].where.x < x; });
+    spawnsDue.clear();
+    for (auto it = first; it != unspawned.end(); ++it)
+    {
+        SDL_FPoint where = spawnList[*it].where;
+        if (where.x > spawnRect.x + spawnRect.w)
+            break;
+        if (where.y >= spawnRect.y && where.y <= spawnRect.y + spawnRect.h)
+            spawnsDue.push_back(*it);
+    }
+    if (!spawnsDue.empty())
+    {
+        std::sort(spawnsDue.begin(), spawnsDue.end());
+        for (size_t index : spawnsDue)
+            spawn(context, index);
+
+        unspawned.erase(std::remove_if(first, unspawned.end(), [&](size_t index) {
+            return std::binary_search(spawnsDue.begin(), spawnsDue.end(), index);
+        }), unspawned.end());
+    }
+
+    // Wider than the spawn range, so a spawn doesn't fall asleep right away
+    entities.setActiveRect(around(activation.dormancyMargin), (uint32_t)activation.dormantInterval);
+}
+
 void GameWorld::step(SceneStepContext& context)
 {
+    // Remember where we were looking for render interpolation
+    previousScrollTarget = scrollTarget;
+
+    // Seen from where the last tick left the view
+    activate(context);
+    entities.commitSpawns();
+
     //// Step all entities
     GameWorldStepContext gameWorldStepContext(
         PassKey<GameWorld>(),
@@ -161,18 +279,48 @@ void GameWorld::step(SceneStepContext& context)
         context.drawing,
         context.currentScene,
         GameWorldAccess(this),
-        LevelAccess(level.get())
+        LevelAccess(level.get()),
+        context.events
     );
 
-    // TODO: Better deadth handling
-    // See if heroEntity doesn't exist, then tell IGame about it
-    // But that requires a fully fledged super duper ultra hyper mega event system that I don't have time for
-    if (heroDied)
+    // Measure once the level's entities exist (--bench-entities)
+    if (!contextsBenchmarked)
     {
-        context.scenes.restart();
+        contextsBenchmarked = true;
+        if (int count = context.engine.getOptions().benchEntities)
+            entities.benchmarkStepContexts(gameWorldStepContext, count);
     }
 
     entities.step(gameWorldStepContext);
+    ticks++;
+
+    // Runs with different --jobs should print the same hashes
+    if (int every = context.engine.getOptions().stateHash)
+    {
+        if (ticks % (uint64_t)every == 0)
+        {
+            char hex[19];
+            snprintf(hex, sizeof(hex), "0x%016llx", (unsigned long long)hashState());
+            std::cout << "State hash @ tick " << ticks << ": " << hex << std::endl;
+        }
+    }
+
+    // Blocks changed this tick get drawn into their chunks again
+    if (level)
+    {
+        uint32_t resets = context.engine.getRenderTargetResets();
+        if (resets != renderTargetResets)
+        {
+            renderTargetResets = resets;
+            level->invalidateChunks();
+        }
+        if (level->hasDirtyChunks())
+        {
+            context.drawing.onRenderThread([&]() {
+                level->refreshChunks(context.drawing.getRenderer());
+            });
+        }
+    }
 
     // TODO: Decouple heroEntity from entityToScrollTo
     if (auto e = heroEntity.get())
@@ -184,42 +332,37 @@ void GameWorld::step(SceneStepContext& context)
 
     if (auto hero = heroEntity.get())
     {
-        auto warpQuery = level->queryBlock(hero->position);
-        if (warpQuery.coll == Level::Block::Collision::NextSection)
+        auto warp = level->getCollision(hero->position);
+        if (warp == Level::Block::Collision::NextSection)
         {
             if (level->nextSection != -1)
             {
                 context.scenes.goToLevel(level->nextSection);
             }
         }
-        if (warpQuery.coll == Level::Block::Collision::Victory)
+        if (warp == Level::Block::Collision::Victory)
         {
-            context.game.declareVictory();
+            context.events.post(VictoryEvent{});
         }
     }
 }
 
-void GameWorld::draw(DrawContext& context)
+uint64_t GameWorld::hashState() const
 {
-    SDL_Renderer* renderer = context.getRenderer();
-
-    // Draw background color
-    SDL_SetRenderDrawColor(
-        renderer,
-        backgroundColor.r,
-        backgroundColor.g,
-        backgroundColor.b,
-        backgroundColor.a
-    );
-    SDL_Rect bounds = context.getBounds();
-    SDL_RenderFillRect(renderer, &bounds);
+    StateHash hash;
+    if (level)
+        level->hashState(hash);
+    entities.hashState(hash);
+    return hash.get();
+}
 
+SDL_Point GameWorld::calculateViewOffset(SDL_Rect screenSize, SDL_FPoint target) const
+{
     // Default scroll offset is at half of the screen size
-    SDL_Rect screenSize = context.getBounds();
     SDL_Rect halfScreen{ 0, 0, screenSize.w / 2,screenSize.h / 2 };
     SDL_Point centerPoint{ halfScreen.w,halfScreen.h };
 
-    // If level exists, base scrolling off of it and draw it.
+    // Without a level there's nothing to scroll along
     if (level)
     {
         SDL_Rect levelSize = level->calculateLevelSize();
@@ -231,19 +374,35 @@ void GameWorld::draw(DrawContext& context)
         if (levelSize.w < screenSize.w)
             centerPoint.x = levelSize.w / 2;
         else
-            centerPoint.x = std::clamp((int)scrollTarget.x, halfScreen.w, levelSize.w - halfScreen.w);
+            centerPoint.x = std::clamp((int)target.x, halfScreen.w, levelSize.w - halfScreen.w);
 
         if (levelSize.h < screenSize.h)
             centerPoint.y = levelSize.h / 2;
         else
-            centerPoint.y = std::clamp((int)scrollTarget.y, halfScreen.h, levelSize.h - halfScreen.h);
+            centerPoint.y = std::clamp((int)target.y, halfScreen.h, levelSize.h - halfScreen.h);
+    }
+
+    return SDL_Point{
+        int(centerPoint.x - halfScreen.w + 0.5f),
+        int(centerPoint.y - halfScreen.h + 0.5f)
+    };
+}
+
+void GameWorld::draw(DrawContext& context)
+{
+    // Draw background color
+    SDL_Rect bounds = context.getBounds();
+    context.fillRect(bounds, backgroundColor);
+
+    // Scroll target blended between the last two ticks
+    SDL_FPoint blendedScrollTarget = context.interpolate(previousScrollTarget, scrollTarget);
 
-        // View offset (top-left in world)
-        SDL_Point viewOffset{
-            int(centerPoint.x - halfScreen.w + 0.5f),
-            int(centerPoint.y - halfScreen.h + 0.5f)
-        };
+    // View offset (top-left in world)
+    SDL_Point viewOffset = calculateViewOffset(context.getBounds(), blendedScrollTarget);
 
+    // If level exists, base scrolling off of it and draw it.
+    if (level)
+    {
         // Derive the current draw context for scrolling with the given offset
         DrawContext scrolledContext = context.deriveForScrolling(viewOffset);
 
@@ -257,12 +416,6 @@ void GameWorld::draw(DrawContext& context)
     {
         // Draw entities without level-based scrolling
 
-        // View offset (top-left in world)
-        SDL_Point viewOffset{
-            int(centerPoint.x - halfScreen.w + 0.5f),
-            int(centerPoint.y - halfScreen.h + 0.5f)
-        };
-
         // Derive the current draw context for scrolling with the given offset
         DrawContext scrolledContext = context.deriveForScrolling(viewOffset);
 
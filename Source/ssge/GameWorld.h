@@ -16,30 +16,46 @@ namespace ssge
         SDL_FRect confines;
         bool gameplayOver;
         int wantedLevel;
-        bool heroDied = false;
+        bool contextsBenchmarked = false; // See EngineOptions::benchEntities
+        uint64_t ticks = 0; // See EngineOptions::stateHash
+        uint32_t renderTargetResets = 0; // Last seen, see Level::invalidateChunks
         bool initLevel(SceneStepContext& context);
         Level::Loader levelLoader;
+        // Spawn list entries not spawned yet, by where.x
+        std::vector<size_t> unspawned;
+        std::vector<size_t> spawnsDue; // Scratch for activate()
+        bool spawn(SceneStepContext& context, size_t spawnIndex);
+        // Spawns what came near the view and puts the rest of the
+        // entities to sleep (see Level::Activation)
+        void activate(SceneStepContext& context);
+        // Top-left of the view in the world, the view centered on target
+        // as far as the level allows
+        SDL_Point calculateViewOffset(SDL_Rect screenSize, SDL_FPoint target) const;
     public:
         GameWorld();
         GameWorld(int wantedLevel);
+        static const ClassID classID;
         static GameWorld* tryCast(Scene* scene);
         Scene& getAsScene();
         EntityManager entities;
         std::unique_ptr<Level> level;
         EntityReference heroEntity;
-        SDL_FPoint scrollTarget;
-        void reportHeroDeadth();
+        SDL_FPoint scrollTarget{ 0,0 };
+        // Scroll target at the start of the current step (for interpolation)
+        SDL_FPoint previousScrollTarget{ 0,0 };
         bool isGameplayOver() const;
         void finishGameplay();
         int getWantedLevel() const;
         SDL_FRect getConstConfines() const;
         SDL_FRect getConfines() const;
         void setConfines(SDL_FRect confines);
-        std::string getSceneClassID() const override;
+        ClassID getSceneClassID() const override;
         void init(SceneStepContext& context) override;
         void step(SceneStepContext& context) override;
         void draw(DrawContext& context) override;
         void drawHUD(DrawContext& context) const;
+        // Level and entity state, for comparing runs (--state-hash)
+        uint64_t hashState() const;
         SDL_Color backgroundColor;
     };
 };
\ No newline at end of file
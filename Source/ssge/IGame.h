@@ -2,6 +2,7 @@
 #include <string>
 #include <memory>
 #include "PassKey.h"
+#include "ClassID.h"
 #include "SDL.h"
 #include "Sprite.h"
 
@@ -40,25 +41,12 @@ namespace ssge
         // Called when it's time to clean up before SDL quits
         virtual void cleanUp(PassKey<Engine> pk) = 0;
 
-        // Called upon shutdown to save settings
+        // Called upon shutdown to save settings.
+        // Settings requested mid-game come as a SaveSettingsEvent.
+        // So do victory, hero deadth, joypad unplugging and quit requests:
+        // subscribe to them through context.events during init().
         virtual bool saveSettings(StepContext& context) = 0;
 
-        // Tells the game implementation to save settings
-        // TODO: Event system!!!
-        virtual void saveSettings() = 0;
-
-        // Tells the game implementation the game was won
-        // TODO: Event system!!!
-        virtual void declareVictory() = 0;
-
-        // Tells the game it's time to quit
-        // TODO: Event system!!!
-        virtual void queryQuit() = 0;
-
-        // Tells the game that a joypad got unplugged
-        // TODO: Event system!!!
-        virtual void joypadGotUnplugged() = 0;
-
         // Get application title
         virtual const char* getApplicationTitle() = 0;
 
@@ -88,10 +76,10 @@ namespace ssge
         virtual ~IGameScenes() = default;
 
         // Called by SceneManager's Accessor to create a scene by ID
-        virtual std::unique_ptr<Scene> createScene(PassKey<ScenesAccess> pk, std::string sceneId) = 0;
+        virtual std::unique_ptr<Scene> createScene(PassKey<ScenesAccess> pk, ClassID sceneId) = 0;
 
         // Tells the sceneID of the main menu scene
-        virtual std::string getMainMenuSceneClassID() const = 0;
+        virtual ClassID getMainMenuSceneClassID() const = 0;
     };
 
     // Gamedev's entity registry
@@ -101,7 +89,13 @@ namespace ssge
         virtual ~IGameEntities() = default;
 
         // Called by EntityManager's Accessor to create an entity by ID
-        virtual std::shared_ptr<Entity> createEntity(PassKey<EntitiesAccess> pk, std::string entityId) = 0;
+        virtual std::unique_ptr<Entity> createEntity(PassKey<EntitiesAccess> pk, ClassID entityId) = 0;
+
+        // Called before a level spawns its entities, once per entity class
+        // in its spawn list, with how many of them there are. Gamedev can
+        // size object pools from it (and account for what those entities
+        // spawn later). Returns how many entities were made room for.
+        virtual size_t reserveEntities(PassKey<EntitiesAccess> pk, ClassID entityId, size_t count) { return count; }
     };
 
     // Gamedev's sprite registry
@@ -111,12 +105,12 @@ namespace ssge
         virtual ~IGameSprites() = default;
 
         // Called by initialization parts of SSGE to load a sprite definition's texture into the GPU via sprite definition ID
-        virtual bool load(std::string sprdefId, SDL_Renderer* renderer) = 0;
+        virtual bool load(ClassID sprdefId, SDL_Renderer* renderer) = 0;
 
         // Called by cleanup parts of SSGE to unload a sprite definition's texture from the GPU via sprite definition ID
-        virtual void unload(std::string sprdefId) = 0;
+        virtual void unload(ClassID sprdefId) = 0;
 
         // Called by parts of SSGE that need to attach a sprite definition somewhere via sprite definition ID
-        virtual const Sprite::Definition* fetchDefinition(const std::string& sprdefId) = 0;
+        virtual const Sprite::Definition* fetchDefinition(ClassID sprdefId) = 0;
     };
 }
@@ -0,0 +1,372 @@
+#include "JobPool.h"
+#include "Profiler.h"
+#include <algorithm>
+#include <iostream>
+
+using namespace ssge;
+
+JobPool::JobPool(PassKey<Engine> pk, int workers)
+{
+	if (workers < 1)
+		workers = 1;
+
+	mainThread = SDL_ThreadID();
+
+	// Never resized after this, workers keep pointers into them
+	queues.resize(workers);
+	starts.reserve(workers);
+
+	if (workers == 1)
+		return;
+
+	wake = SDL_CreateSemaphore(0);
+	done = SDL_CreateSemaphore(0);
+	if (!wake || !done)
+	{
+		std::cout << "JobPool: SDL_CreateSemaphore error: " << SDL_GetError()
+			<< ". Running jobs on the calling thread." << std::endl;
+		return;
+	}
+
+	for (int worker = 1; worker < workers; worker++)
+	{
+		starts.push_back(WorkerStart{ this, worker });
+		SDL_Thread* thread = SDL_CreateThread(threadMain, "Jobs", &starts.back());
+		if (!thread)
+		{
+			std::cout << "JobPool: SDL_CreateThread error: " << SDL_GetError()
+				<< ". Continuing with " << worker << " workers." << std::endl;
+			break;
+		}
+		threads.push_back(thread);
+	}
+
+	workerCount = (int)threads.size() + 1;
+}
+
+JobPool::~JobPool()
+{
+	// Whatever was started gets finished
+	while (SDL_AtomicGet(&outstanding) > 0)
+	{
+		if (!helpOnce())
+			SDL_Delay(1);
+	}
+
+	SDL_AtomicSet(&quitting, 1);
+	for (size_t i = 0; i < threads.size(); i++)
+		SDL_SemPost(wake);
+	for (SDL_Thread* thread : threads)
+		SDL_WaitThread(thread, nullptr);
+
+	if (wake)
+		SDL_DestroySemaphore(wake);
+	if (done)
+		SDL_DestroySemaphore(done);
+}
+
+int JobPool::threadMain(void* start)
+{
+	WorkerStart* workerStart = static_cast<WorkerStart*>(start);
+	JobPool* pool = workerStart->pool;
+
+	Profiler::nameThread("Jobs");
+
+	for (;;)
+	{
+		SDL_SemWait(pool->wake);
+		if (SDL_AtomicGet(&pool->quitting))
+			break;
+		pool->work(workerStart->worker);
+	}
+
+	return 0;
+}
+
+template<typename T>
+bool JobPool::take(int worker, std::deque<T> Queue::* items, T& item)
+{
+	{ // Own queue, in order
+		Queue& queue = queues[worker];
+		SDL_AtomicLock(&queue.lock);
+		std::deque<T>& own = queue.*items;
+		bool found = !own.empty();
+		if (found)
+		{
+			item = own.front();
+			own.pop_front();
+		}
+		SDL_AtomicUnlock(&queue.lock);
+		if (found)
+			return true;
+	}
+
+	// Steal from the far end of someone else's
+	for (int offset = 1; offset < workerCount; offset++)
+	{
+		Queue& queue = queues[(worker + offset) % workerCount];
+		SDL_AtomicLock(&queue.lock);
+		std::deque<T>& others = queue.*items;
+		bool found = !others.empty();
+		if (found)
+		{
+			item = others.back();
+			others.pop_back();
+		}
+		SDL_AtomicUnlock(&queue.lock);
+		if (found)
+			return true;
+	}
+
+	return false;
+}
+
+void JobPool::work(int worker)
+{
+	Range range;
+	uint32_t task;
+	for (;;)
+	{
+		// Chunks first, parallelFor's caller is waiting on them
+		if (take(worker, &Queue::ranges, range))
+		{
+			(*job)(range.begin, range.end, worker);
+
+			// Whoever finishes the last chunk lets parallelFor return
+			if (SDL_AtomicAdd(&remaining, -1) == 1)
+				SDL_SemPost(done);
+		}
+		else if (take(worker, &Queue::tasks, task))
+		{
+			runTask(task);
+		}
+		else
+		{
+			break;
+		}
+	}
+}
+
+void JobPool::parallelFor(size_t count, size_t grain, const RangeJob& job)
+{
+	if (count == 0)
+		return;
+	if (grain == 0)
+		grain = 1;
+
+	size_t chunks = (count + grain - 1) / grain;
+	if (workerCount == 1 || chunks == 1)
+	{ // Nothing to share
+		job(0, count, 0);
+		return;
+	}
+
+	// Set before any chunk is visible. Taking a chunk goes through the
+	// queue's lock, which orders this before the worker's read.
+	this->job = &job;
+	SDL_AtomicSet(&remaining, (int)chunks);
+
+	// Neighbouring chunks stay with the same worker unless stolen
+	for (int worker = 0; worker < workerCount; worker++)
+	{
+		size_t first = chunks * worker / workerCount;
+		size_t last = chunks * (worker + 1) / workerCount;
+
+		Queue& queue = queues[worker];
+		SDL_AtomicLock(&queue.lock);
+		for (size_t chunk = first; chunk < last; chunk++)
+			queue.ranges.push_back(Range{ chunk * grain, std::min(count, (chunk + 1) * grain) });
+		SDL_AtomicUnlock(&queue.lock);
+	}
+
+	for (size_t i = 0; i < threads.size(); i++)
+		SDL_SemPost(wake);
+
+	// Only chunks here, a task could take a while
+	Range range;
+	while (take(0, &Queue::ranges, range))
+	{
+		job(range.begin, range.end, 0);
+		if (SDL_AtomicAdd(&remaining, -1) == 1)
+			SDL_SemPost(done);
+	}
+	SDL_SemWait(done);
+
+	this->job = nullptr;
+}
+
+JobPool::TaskHandle JobPool::enqueue(Task task, const std::vector<TaskHandle>& after, bool onMainThread)
+{
+	SDL_AtomicAdd(&outstanding, 1);
+
+	SDL_AtomicLock(&taskLock);
+
+	uint32_t index = firstFreeTask;
+	if (index != 0xFFFFFFFFu)
+	{
+		firstFreeTask = tasks[index].nextFree;
+	}
+	else
+	{
+		index = (uint32_t)tasks.size();
+		tasks.emplace_back();
+	}
+
+	TaskSlot& slot = tasks[index];
+	slot.run = std::move(task);
+	slot.mainThread = onMainThread;
+	slot.waitingOn = 0;
+	for (const TaskHandle& dependency : after)
+	{
+		if (isDoneLocked(dependency))
+			continue;
+		tasks[dependency.index].dependents.push_back(index);
+		slot.waitingOn++;
+	}
+
+	TaskHandle handle{ index, slot.generation };
+	bool ready = slot.waitingOn == 0;
+
+	SDL_AtomicUnlock(&taskLock);
+
+	if (ready)
+		makeReady(index);
+
+	return handle;
+}
+
+bool JobPool::isDoneLocked(TaskHandle task) const
+{
+	return task.index >= tasks.size() || tasks[task.index].generation != task.generation;
+}
+
+void JobPool::makeReady(uint32_t task)
+{
+	SDL_AtomicLock(&taskLock);
+	bool onMainThread = tasks[task].mainThread;
+	SDL_AtomicUnlock(&taskLock);
+
+	if (onMainThread)
+	{
+		SDL_AtomicLock(&mainLock);
+		mainTasks.push_back(task);
+		SDL_AtomicUnlock(&mainLock);
+		return;
+	}
+
+	if (threads.empty())
+	{ // Nobody else to run it
+		runTask(task);
+		return;
+	}
+
+	// Spread over the threads, the main thread only helps out
+	SDL_AtomicLock(&taskLock);
+	Queue& queue = queues[1 + nextQueue++ % threads.size()];
+	SDL_AtomicUnlock(&taskLock);
+
+	SDL_AtomicLock(&queue.lock);
+	queue.tasks.push_back(task);
+	SDL_AtomicUnlock(&queue.lock);
+
+	SDL_SemPost(wake);
+}
+
+void JobPool::runTask(uint32_t task)
+{
+	SDL_AtomicLock(&taskLock);
+	Task run = std::move(tasks[task].run);
+	SDL_AtomicUnlock(&taskLock);
+
+	run();
+
+	// Done: bump the generation, free the slot and let go of whoever
+	// was only waiting on this one
+	std::vector<uint32_t> released;
+	SDL_AtomicLock(&taskLock);
+	TaskSlot& slot = tasks[task];
+	slot.run = nullptr;
+	slot.generation++;
+	slot.nextFree = firstFreeTask;
+	firstFreeTask = task;
+	for (uint32_t dependent : slot.dependents)
+	{
+		if (--tasks[dependent].waitingOn == 0)
+			released.push_back(dependent);
+	}
+	slot.dependents.clear();
+	SDL_AtomicUnlock(&taskLock);
+
+	SDL_AtomicAdd(&outstanding, -1);
+
+	for (uint32_t dependent : released)
+		makeReady(dependent);
+}
+
+bool JobPool::runMainThreadTask()
+{
+	SDL_AtomicLock(&mainLock);
+	bool found = !mainTasks.empty();
+	uint32_t task = 0;
+	if (found)
+	{
+		task = mainTasks.front();
+		mainTasks.pop_front();
+	}
+	SDL_AtomicUnlock(&mainLock);
+
+	if (found)
+		runTask(task);
+	return found;
+}
+
+bool JobPool::helpOnce()
+{
+	if (SDL_ThreadID() == mainThread && runMainThreadTask())
+		return true;
+
+	uint32_t task;
+	if (take(0, &Queue::tasks, task))
+	{
+		runTask(task);
+		return true;
+	}
+	return false;
+}
+
+JobPool::TaskHandle JobPool::submit(Task task, const std::vector<TaskHandle>& after)
+{
+	return enqueue(std::move(task), after, false);
+}
+
+JobPool::TaskHandle JobPool::submitToMainThread(Task task, const std::vector<TaskHandle>& after)
+{
+	return enqueue(std::move(task), after, true);
+}
+
+bool JobPool::isDone(TaskHandle task) const
+{
+	SDL_AtomicLock(&taskLock);
+	bool done = isDoneLocked(task);
+	SDL_AtomicUnlock(&taskLock);
+	return done;
+}
+
+void JobPool::wait(TaskHandle task)
+{
+	while (!isDone(task))
+	{
+		if (!helpOnce())
+			SDL_Delay(1);
+	}
+}
+
+void JobPool::serveMainThread(PassKey<Engine> pk)
+{
+	// Just what's queued now, tasks it releases can wait for next time
+	SDL_AtomicLock(&mainLock);
+	size_t count = mainTasks.size();
+	SDL_AtomicUnlock(&mainLock);
+
+	for (size_t i = 0; i < count && runMainThreadTask(); i++) {}
+}
@@ -0,0 +1,140 @@
+#pragma once
+#include <SDL.h>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <vector>
+#include "PassKey.h"
+
+namespace ssge
+{
+	class Engine;
+
+	// The engine's worker threads. Two kinds of work go through them:
+	//
+	// - parallelFor cuts [0, count) into chunks and deals them out in
+	//   order, one run of chunks per worker queue. The calling thread is
+	//   worker 0 and works too. It returns once every chunk is done.
+	// - Tasks are one-off jobs (decoding a file, building a table) that
+	//   may wait for other tasks to finish first. A task meant for the
+	//   main thread (SDL calls that must happen there) waits in the main
+	//   thread queue, which the Engine serves every frame.
+	//
+	// Workers take from the front of their own queue and, once it runs
+	// dry, steal from the back of the others, so uneven work evens out.
+	//
+	// SDL threads and SDL atomics only: the XP toolchain has no std::thread.
+	class JobPool
+	{
+	public:
+		// Works through [begin, end) as worker number worker
+		using RangeJob = std::function<void(size_t begin, size_t end, int worker)>;
+		using Task = std::function<void()>;
+
+		// Identifies a submitted task. Stays valid after the task is done
+		// (it then just reads as done). A default one is always done.
+		struct TaskHandle
+		{
+			uint32_t index = 0xFFFFFFFFu;
+			uint32_t generation = 0;
+		};
+
+	private:
+		struct Range
+		{
+			size_t begin;
+			size_t end;
+		};
+
+		struct Queue
+		{
+			SDL_SpinLock lock = 0;
+			std::deque<Range> ranges;
+			std::deque<uint32_t> tasks; // Ready to run, by task slot
+		};
+
+		struct TaskSlot
+		{
+			Task run;
+			uint32_t generation = 1; // Bumped when the task is done
+			int waitingOn = 0;       // Unfinished dependencies
+			bool mainThread = false;
+			std::vector<uint32_t> dependents;
+			uint32_t nextFree = 0xFFFFFFFFu;
+		};
+
+		struct WorkerStart
+		{
+			JobPool* pool;
+			int worker;
+		};
+
+		int workerCount = 1;
+		std::vector<Queue> queues; // One per worker
+		std::vector<WorkerStart> starts;
+		std::vector<SDL_Thread*> threads;
+		SDL_sem* wake = nullptr; // Posted per worker per parallelFor, and per ready task
+		SDL_sem* done = nullptr; // Posted when the last chunk is done
+		SDL_atomic_t remaining{}; // Chunks not done yet
+		SDL_atomic_t quitting{};
+		const RangeJob* job = nullptr;
+
+		// Task slots get reused, a deque so they stay put while growing
+		mutable SDL_SpinLock taskLock = 0;
+		std::deque<TaskSlot> tasks;
+		uint32_t firstFreeTask = 0xFFFFFFFFu;
+		uint32_t nextQueue = 0;      // Round robin over the threads for ready tasks
+		SDL_atomic_t outstanding{};  // Submitted, not done
+
+		SDL_SpinLock mainLock = 0;
+		std::deque<uint32_t> mainTasks; // Ready to run on the main thread
+		SDL_threadID mainThread = 0;
+
+		// Own queue first, then steal
+		template<typename T>
+		bool take(int worker, std::deque<T> Queue::* items, T& item);
+		// Runs chunks and tasks until there are none left to take
+		void work(int worker);
+		static int threadMain(void* start);
+
+		TaskHandle enqueue(Task task, const std::vector<TaskHandle>& after, bool onMainThread);
+		bool isDoneLocked(TaskHandle task) const;
+		void makeReady(uint32_t task);
+		void runTask(uint32_t task);
+		// Runs one main thread task, false if there were none
+		bool runMainThreadTask();
+		// Runs one ready task (or main thread task there), false if there were none
+		bool helpOnce();
+
+	public:
+		// Starts workers - 1 threads. Falls back to fewer (down to running
+		// everything on the caller) if threads can't be created.
+		// The thread that makes the pool is its main thread.
+		JobPool(PassKey<Engine> pk, int workers);
+		JobPool(const JobPool& toCopy) = delete;
+		JobPool(JobPool&& toMove) = delete;
+		// Finishes every outstanding task first. Call on the main thread.
+		~JobPool();
+
+		// Threads plus the caller
+		int getWorkerCount() const { return workerCount; }
+
+		// Runs job over [0, count) in chunks of grain indexes.
+		// Only one thread may use it at a time, and not from inside a job
+		// or a task.
+		void parallelFor(size_t count, size_t grain, const RangeJob& job);
+
+		// Runs task on a worker once every task in after is done. Without
+		// worker threads a ready task runs right away, on the caller.
+		TaskHandle submit(Task task, const std::vector<TaskHandle>& after = {});
+		// Same, but on the main thread
+		TaskHandle submitToMainThread(Task task, const std::vector<TaskHandle>& after = {});
+
+		bool isDone(TaskHandle task) const;
+		// Returns once task is done, running other tasks meanwhile
+		void wait(TaskHandle task);
+
+		// Main thread: runs the tasks queued for it
+		void serveMainThread(PassKey<Engine> pk);
+	};
+}
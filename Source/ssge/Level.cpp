@@ -1,10 +1,13 @@
 #include "Level.h"
 #include <cstring>
+#include <cstdlib>
 #include <algorithm>
 #include <string>
 #include "SdlTexture.h"
 #include <fstream>
 #include <vector>
+#include "Profiler.h"
+#include "JobPool.h"
 
 namespace ssge
 {
@@ -17,6 +20,41 @@ namespace ssge
 		return type.getIndex();
 	}
 
+	const Level::Block::Callback Level::Block::Callback::NONE{};
+
+	Level::Block::Callback Level::Block::Callback::compile(const std::string& source)
+	{
+		Callback compiled;
+
+		// Name: everything up to the first operand marker
+		std::size_t nameEnd = source.find_first_of(">,<^");
+		std::string name = source.substr(0, nameEnd);
+		while (!name.empty() && (name.back() == ' ' || name.back() == '-'))
+			name.pop_back(); // "Terraform->X"
+		compiled.opcode = ClassID(name);
+
+		// Operands: an integer right after a marker, if there is one
+		for (std::size_t i = nameEnd; i < source.size(); i++)
+		{
+			const char* markers = ">,<^";
+			const char* marker = std::strchr(markers, source[i]);
+			if (!marker || !*marker)
+				continue;
+
+			const char* start = source.c_str() + i + 1;
+			char* end = nullptr;
+			long value = std::strtol(start, &end, 10);
+			if (end == start)
+				continue; // Marker without a number
+
+			int operand = (int)(marker - markers);
+			compiled.operands[operand] = (int)value;
+			compiled.present |= (uint8_t)(1u << operand);
+		}
+
+		return compiled;
+	}
+
 	// -------------- Iterator ---------------
 	Level::Iterator::Iterator(Level& lvl) : level(lvl) {}
 
@@ -37,6 +75,15 @@ namespace ssge
 	{
 		const std::size_t count = static_cast<std::size_t>(columns) * static_cast<std::size_t>(rows);
 		array = (count > 0) ? new Block[count] : nullptr;
+		collisionLayer.assign(count, (uint8_t)Block::Collision::Air);
+		rowWords = columns > 0 ? (columns + 63) / 64 : 0;
+		columnWords = rows > 0 ? (rows + 63) / 64 : 0;
+		solidByRow.assign(static_cast<std::size_t>(std::max(rows, 0)) * rowWords, 0);
+		solidByColumn.assign(static_cast<std::size_t>(std::max(columns, 0)) * columnWords, 0);
+		waterByRow.assign(solidByRow.size(), 0);
+		chunkColumns = columns > 0 ? (columns + CHUNK_SIZE - 1) / CHUNK_SIZE : 0;
+		chunkRows = rows > 0 ? (rows + CHUNK_SIZE - 1) / CHUNK_SIZE : 0;
+		chunks.resize(static_cast<std::size_t>(chunkColumns) * chunkRows);
 		tilesetMeta.tileW = blockSize.w;
 		tilesetMeta.tileH = blockSize.h;
 
@@ -50,6 +97,7 @@ namespace ssge
 	{
 		delete[] array;
 		array = nullptr;
+		freeDecoded();
 	}
 
 	Level::Level(Level&& other) noexcept
@@ -58,6 +106,17 @@ namespace ssge
 		, blockSize(other.blockSize)
 		, tilesetTexture(std::move(other.tilesetTexture))
 		, array(other.array)
+		, collisionLayer(std::move(other.collisionLayer))
+		, rowWords(other.rowWords)
+		, columnWords(other.columnWords)
+		, solidByRow(std::move(other.solidByRow))
+		, solidByColumn(std::move(other.solidByColumn))
+		, waterByRow(std::move(other.waterByRow))
+		, chunks(std::move(other.chunks))
+		, chunkColumns(other.chunkColumns)
+		, chunkRows(other.chunkRows)
+		, anyChunkDirty(other.anyChunkDirty)
+		, chunksSupported(other.chunksSupported)
 		, throughTopLeft(other.throughTopLeft)
 		, throughTop(other.throughTop)
 		, throughTopRight(other.throughTopRight)
@@ -67,9 +126,12 @@ namespace ssge
 		, throughBottom(other.throughBottom)
 		, throughBottomRight(other.throughBottomRight)
 		, nextSection(other.nextSection)
+		, activation(other.activation)
 		, backgrounds(std::move(other.backgrounds))
+		, decodedImages(std::move(other.decodedImages))
 	{
 		other.array = nullptr;
+		other.decodedImages.clear();
 
 		for (std::size_t i = 0; i < MAX_BLOCK_DEFINITIONS; i++)
 		{
@@ -88,6 +150,17 @@ namespace ssge
 			// Here we just adopt the underlying storage and public resources:
 			tilesetTexture = std::move(other.tilesetTexture);
 			array = other.array;
+			collisionLayer = std::move(other.collisionLayer);
+			rowWords = other.rowWords;
+			columnWords = other.columnWords;
+			solidByRow = std::move(other.solidByRow);
+			solidByColumn = std::move(other.solidByColumn);
+			waterByRow = std::move(other.waterByRow);
+			chunks = std::move(other.chunks);
+			chunkColumns = other.chunkColumns;
+			chunkRows = other.chunkRows;
+			anyChunkDirty = other.anyChunkDirty;
+			chunksSupported = other.chunksSupported;
 			throughTopLeft = other.throughTopLeft;
 			throughTop = other.throughTop;
 			throughTopRight = other.throughTopRight;
@@ -97,6 +170,9 @@ namespace ssge
 			throughBottom = other.throughBottom;
 			throughBottomRight = other.throughBottomRight;
 			other.array = nullptr;
+			freeDecoded();
+			decodedImages = std::move(other.decodedImages);
+			other.decodedImages.clear();
 			for (std::size_t i = 0; i < MAX_BLOCK_DEFINITIONS; i++)
 			{
 				blockDefinitions[i] = std::move(other.blockDefinitions[i]);
@@ -145,6 +221,230 @@ namespace ssge
 		return getConstBlockAt(Block::Coords(c, r));
 	}
 
+	bool Level::setBlockType(Block::Coords coords, int type)
+	{
+		Block* block = getBlockAt(coords);
+		if (!block) return false;
+		block->type = type;
+		setCollision(coords.column, coords.row, getBlockCollisionType(*block));
+		markChunkDirty(coords.column, coords.row);
+		return true;
+	}
+
+	void Level::buildCollisionLayer()
+	{
+		for (int row = 0; row < rows; row++)
+			for (int col = 0; col < columns; col++)
+				setCollision(col, row, getBlockCollisionType(array[indexOf(row, col)]));
+	}
+
+	void Level::setCollision(int col, int row, Block::Collision collision)
+	{
+		collisionLayer[indexOf(row, col)] = (uint8_t)collision;
+
+		uint64_t& solidInRow = solidByRow[row * rowWords + (col >> 6)];
+		uint64_t& solidInColumn = solidByColumn[col * columnWords + (row >> 6)];
+		uint64_t& waterInRow = waterByRow[row * rowWords + (col >> 6)];
+		const uint64_t columnBit = 1ull << (col & 63);
+		const uint64_t rowBit = 1ull << (row & 63);
+
+		if (collision == Block::Collision::Solid)
+		{
+			solidInRow |= columnBit;
+			solidInColumn |= rowBit;
+		}
+		else
+		{
+			solidInRow &= ~columnBit;
+			solidInColumn &= ~rowBit;
+		}
+
+		if (collision == Block::Collision::Water)
+			waterInRow |= columnBit;
+		else
+			waterInRow &= ~columnBit;
+	}
+
+	// First set bit in [lo, hi] of a mask line, -1 if none
+	static int firstBitIn(const uint64_t* words, int lo, int hi)
+	{
+		for (int word = lo >> 6; word <= (hi >> 6); word++)
+		{
+			uint64_t bits = words[word];
+			if (word == (lo >> 6)) bits &= ~0ull << (lo & 63);
+			if (word == (hi >> 6)) bits &= ~0ull >> (63 - (hi & 63));
+			if (bits) return (word << 6) + lowestBit(bits);
+		}
+		return -1;
+	}
+
+	// Last set bit in [lo, hi] of a mask line, -1 if none
+	static int lastBitIn(const uint64_t* words, int lo, int hi)
+	{
+		for (int word = hi >> 6; word >= (lo >> 6); word--)
+		{
+			uint64_t bits = words[word];
+			if (word == (lo >> 6)) bits &= ~0ull << (lo & 63);
+			if (word == (hi >> 6)) bits &= ~0ull >> (63 - (hi & 63));
+			if (bits) return (word << 6) + highestBit(bits);
+		}
+		return -1;
+	}
+
+	bool Level::spanHas(Block::Collision what, const std::vector<uint64_t>& byRow,
+		int col0, int col1, int row0, int row1) const
+	{
+		// Before, inside and after the level, along each axis
+		const int colBands[3][2] = {
+			{ col0, std::min(col1, -1) },
+			{ std::max(col0, 0), std::min(col1, columns - 1) },
+			{ std::max(col0, columns), col1 } };
+		const int rowBands[3][2] = {
+			{ row0, std::min(row1, -1) },
+			{ std::max(row0, 0), std::min(row1, rows - 1) },
+			{ std::max(row0, rows), row1 } };
+
+		for (int i = 0; i < 3; i++)
+		{
+			if (rowBands[i][0] > rowBands[i][1])
+				continue;
+			for (int j = 0; j < 3; j++)
+			{
+				if (colBands[j][0] > colBands[j][1])
+					continue;
+
+				if (i == 1 && j == 1)
+				{ // Inside: one mask test per row
+					for (int row = rowBands[1][0]; row <= rowBands[1][1]; row++)
+						if (firstBitIn(&byRow[row * rowWords], colBands[1][0], colBands[1][1]) >= 0)
+							return true;
+				}
+				else if (getCollision(colBands[j][0], rowBands[i][0]) == what)
+				{ // A side or corner outside the level has one policy
+					return true;
+				}
+			}
+		}
+		return false;
+	}
+
+	bool Level::findFirstSolid(bool horizontal, int from, int to, int step,
+		int line0, int line1, int& along, int& line) const
+	{
+		using Collision = Block::Collision;
+
+		if ((to - from) * step < 0 || line0 > line1)
+			return false;
+
+		const int alongCount = horizontal ? columns : rows;
+		const int lineCount = horizontal ? rows : columns;
+		const int words = horizontal ? rowWords : columnWords;
+		const std::vector<uint64_t>& masks = horizontal ? solidByRow : solidByColumn;
+		auto collisionAt = [&](int a, int l) {
+			return horizontal ? getCollision(a, l) : getCollision(l, a);
+		};
+
+		// Lines before, inside and after the level
+		const int lineBands[3][2] = {
+			{ line0, std::min(line1, -1) },
+			{ std::max(line0, 0), std::min(line1, lineCount - 1) },
+			{ std::max(line0, lineCount), line1 } };
+
+		// Walk the stretches before, inside and after the level in order
+		const int lo = std::min(from, to), hi = std::max(from, to);
+		int stretches[3][2] = {
+			{ lo, std::min(hi, -1) },
+			{ std::max(lo, 0), std::min(hi, alongCount - 1) },
+			{ std::max(lo, alongCount), hi } };
+		if (step < 0)
+			std::swap(stretches[0], stretches[2]);
+
+		for (const auto& stretch : stretches)
+		{
+			if (stretch[0] > stretch[1])
+				continue;
+			const int first = step > 0 ? stretch[0] : stretch[1];
+
+			if (first < 0 || first >= alongCount)
+			{ // Outside the level every cell of a band is alike
+				for (const auto& band : lineBands)
+				{
+					if (band[0] <= band[1] && collisionAt(first, band[0]) == Collision::Solid)
+					{
+						along = first;
+						line = band[0];
+						return true;
+					}
+				}
+				continue;
+			}
+
+			// Inside: lines outside the level are alike along the stretch,
+			// lines inside take one mask search each
+			if (lineBands[0][0] <= lineBands[0][1] && collisionAt(first, lineBands[0][0]) == Collision::Solid)
+			{
+				along = first;
+				line = lineBands[0][0];
+				return true;
+			}
+
+			int best = -1;
+			for (int l = lineBands[1][0]; l <= lineBands[1][1] && best != first; l++)
+			{
+				const uint64_t* mask = &masks[l * words];
+				int found = step > 0 ? firstBitIn(mask, stretch[0], stretch[1])
+					: lastBitIn(mask, stretch[0], stretch[1]);
+				if (found >= 0 && (best < 0 || (found - best) * step < 0))
+					best = found;
+			}
+			if (lineBands[2][0] <= lineBands[2][1] && collisionAt(first, lineBands[2][0]) == Collision::Solid)
+				best = first;
+			if (best < 0)
+				continue;
+
+			along = best;
+			line = lineBands[2][0];
+			for (int l = lineBands[1][0]; l <= lineBands[1][1]; l++)
+			{
+				if ((masks[l * words + (best >> 6)] >> (best & 63)) & 1u)
+				{
+					line = l;
+					break;
+				}
+			}
+			return true;
+		}
+		return false;
+	}
+
+
+	void Level::applyJournals(const std::vector<WriteJournal>& journals, std::vector<WriteJournal::Write>& merged)
+	{
+		merged.clear();
+		for (const auto& journal : journals)
+			merged.insert(merged.end(), journal.getWrites().begin(), journal.getWrites().end());
+
+		std::sort(merged.begin(), merged.end(),
+			[](const WriteJournal::Write& a, const WriteJournal::Write& b) {
+				if (a.order != b.order) return a.order < b.order;
+				return a.sequence < b.sequence;
+			});
+
+		for (const auto& write : merged)
+			setBlockType(write.coords, write.type);
+	}
+
+	void Level::hashState(StateHash& hash) const
+	{
+		hash.add(columns);
+		hash.add(rows);
+		if (!array) return;
+
+		const std::size_t count = static_cast<std::size_t>(columns) * static_cast<std::size_t>(rows);
+		for (std::size_t i = 0; i < count; i++)
+			hash.add(array[i].type.getIndex());
+	}
+
 	Level::Block::Collision Level::getCollisionAt(SDL_FPoint point) const
 	{
 		const SDL_Rect size = calculateLevelSize();
@@ -200,25 +500,36 @@ namespace ssge
 	}
 
 	// Return tile indices overlapped by a rect (clamped to level bounds).
+	// What spans and sweeps pull a far edge in by, so it doesn't reach
+	// into the next cell
+	static inline float nudge(float) { return 0.0001f; }
+	static inline Fixed nudge(Fixed) { return Fixed::epsilon(); }
+
 	void Level::rectToBlockSpan(const SDL_FRect& r, int& col0, int& col1, int& row0, int& row1) const
 	{
-		const float eps = 0.0001f;
+		boxToBlockSpan(Box<float>{ r.x, r.y, r.w, r.h }, col0, col1, row0, row1);
+	}
+
+	template<typename Real>
+	void Level::boxToBlockSpan(const Box<Real>& r, int& col0, int& col1, int& row0, int& row1) const
+	{
+		const Real eps = nudge(Real());
 		const int w = blockSize.w, h = blockSize.h;
 
-		if (r.w <= 0.f || r.h <= 0.f)
+		if (r.w <= Real(0) || r.h <= Real(0))
 		{
 			// Degenerate rect -> clamp to a single tile under r.x,r.y
-			int c = std::max(0, std::min(columns - 1, worldToCol(r.x, w)));
-			int rI = std::max(0, std::min(rows - 1, worldToRow(r.y, h)));
+			int c = std::max(0, std::min(columns - 1, cellOf(r.x, w)));
+			int rI = std::max(0, std::min(rows - 1, cellOf(r.y, h)));
 			col0 = col1 = c;
 			row0 = row1 = rI;
 			return;
 		}
 
-		int c0 = worldToCol(r.x, w);
-		int c1 = worldToCol(r.x + r.w - eps, w);
-		int r0 = worldToRow(r.y, h);
-		int r1 = worldToRow(r.y + r.h - eps, h);
+		int c0 = cellOf(r.x, w);
+		int c1 = cellOf(r.x + r.w - eps, w);
+		int r0 = cellOf(r.y, h);
+		int r1 = cellOf(r.y + r.h - eps, h);
 
 		// Won't need this anymore
 		// Clamp to level bounds
@@ -254,13 +565,10 @@ namespace ssge
 	}
 
 	// Query a tile (with OOB policy)
-	Level::BlockQuery Level::queryBlock(int col, int row) const
+	Level::Block::Collision Level::outOfBoundsCollision(int col, int row) const
 	{
 		using Collision = Level::Block::Collision;
 
-		BlockQuery q;
-		q.coords = { col,row };
-
 		// OOB is like a Tic-Tac-Toe index here, hehe
 		// 012
 		// 345
@@ -286,23 +594,20 @@ namespace ssge
 		};
 
 		const Collision* collision = oobLut[oob];
+		return collision ? *collision : Collision::Air;
+	}
 
-		if (collision) // Out of bounds
-		{
-			q.insideLevel = false;
-			// Decide collision for OOB
- 			q.coll = *collision;
-			q.type = Level::Block::Type::EMPTY;
-			return q;
-		}
-		else // Not out of bounds
-		{
-			q.insideLevel = true;
-			const Block& b = array[row * columns + col];
-			q.coll = getBlockCollisionType(b);
-			q.type = b.type;
-			q.callback = getBlockCallbackString(b);
-		}
+	Level::BlockQuery Level::queryBlock(int col, int row) const
+	{
+		BlockVisit visit = visitBlock(col, row);
+
+		BlockQuery q;
+		q.coords = visit.coords;
+		q.type = visit.type;
+		q.coll = visit.coll;
+		if (visit.insideLevel)
+			q.callback = blockDefinitions[definitionOf(visit.type.getIndex())].callback;
+		q.insideLevel = visit.insideLevel;
 		return q;
 	}
 
@@ -315,79 +620,90 @@ namespace ssge
 
 	// Is any overlapped tile "water"?
 	bool Level::rectInWater(const SDL_FRect& r) const
+	{
+		return rectInWater(Box<float>{ r.x, r.y, r.w, r.h });
+	}
+
+	template<typename Real>
+	bool Level::rectInWater(const Box<Real>& r) const
 	{
 		int c0, c1, r0, r1;
-		rectToBlockSpan(r, c0, c1, r0, r1);
-		for (int rI = r0; rI <= r1; ++rI)
-			for (int cI = c0; cI <= c1; ++cI)
-				if (queryBlock(cI, rI).coll == Level::Block::Collision::Water)
-					return true;
-		return false;
+		boxToBlockSpan(r, c0, c1, r0, r1);
+		return spanHas(Level::Block::Collision::Water, waterByRow, c0, c1, r0, r1);
 	}
 
-	static constexpr float EPS = 0.0001f;
+	// Is any overlapped tile solid?
+	bool Level::rectInSolid(const SDL_FRect& r) const
+	{
+		return rectInSolid(Box<float>{ r.x, r.y, r.w, r.h });
+	}
+
+	template<typename Real>
+	bool Level::rectInSolid(const Box<Real>& r) const
+	{
+		int c0, c1, r0, r1;
+		boxToBlockSpan(r, c0, c1, r0, r1);
+		return spanHas(Level::Block::Collision::Solid, solidByRow, c0, c1, r0, r1);
+	}
 
 	// Axis-separated sweep: move horizontally by dx, collide with solids.
 	Level::SweepHit Level::sweepHorizontal(const SDL_FRect& rect, float dx) const
 	{
-		SweepHit out; out.hit = false;
+		return sweepHorizontal(Box<float>{ rect.x, rect.y, rect.w, rect.h }, dx);
+	}
+
+	template<typename Real>
+	Level::BasicSweepHit<Real> Level::sweepHorizontal(const Box<Real>& rect, Real dx) const
+	{
+		SSGE_PROFILE_ZONE("Level::sweepHorizontal");
+
+		BasicSweepHit<Real> out; out.hit = false;
+		const Real eps = nudge(Real());
 		const int w = blockSize.w, h = blockSize.h;
-		SDL_FRect box = rect;
+		Box<Real> box = rect;
 
 		int col0, col1, row0, row1;
-		rectToBlockSpan(box, col0, col1, row0, row1);
+		boxToBlockSpan(box, col0, col1, row0, row1);
 
-		if (dx > 0.f)
+		if (dx > Real(0))
 		{
-			float right0 = box.x + box.w;
-			float right1 = right0 + dx;
+			Real right0 = box.x + box.w;
+			Real right1 = right0 + dx;
 			// INCLUDE boundary tile at right0
-			int startCol = worldToCol(right0, w);
-			int endCol = worldToCol(right1 - EPS, w);
+			int startCol = cellOf(right0, w);
+			int endCol = cellOf(right1 - eps, w);
 
-			for (int c = startCol; c <= endCol; ++c)
+			int c, rI;
+			if (findFirstSolid(true, startCol, endCol, 1, row0, row1, c, rI))
 			{
-				for (int rI = row0; rI <= row1; ++rI)
-				{
-					auto q = queryBlock(c, rI);
-					if (q.coll == Block::Collision::Solid)
-					{
-						float tileLeft = float(c * w);
-						out.hit = true;
-						out.coords = { c,rI };
-						out.newX = tileLeft - box.w;
-						out.newY = box.y;
-						return out;
-					}
-				}
+				Real tileLeft = Real(c * w);
+				out.hit = true;
+				out.coords = { c,rI };
+				out.newX = tileLeft - box.w;
+				out.newY = box.y;
+				return out;
 			}
 			out.newX = rect.x + dx;
 			out.newY = rect.y;
 			return out;
 		}
-		else if (dx < 0.f)
+		else if (dx < Real(0))
 		{
-			float left0 = box.x;
-			float left1 = left0 + dx;
+			Real left0 = box.x;
+			Real left1 = left0 + dx;
 			// For left, step into columns we cross moving left; use a tiny -EPS to include boundary
-			int startCol = worldToCol(left0 - EPS, w);
-			int endCol = worldToCol(left1 + EPS, w);
+			int startCol = cellOf(left0 - eps, w);
+			int endCol = cellOf(left1 + eps, w);
 
-			for (int c = startCol; c >= endCol; --c)
+			int c, rI;
+			if (findFirstSolid(true, startCol, endCol, -1, row0, row1, c, rI))
 			{
-				for (int rI = row0; rI <= row1; ++rI)
-				{
-					auto q = queryBlock(c, rI);
-					if (q.coll == Block::Collision::Solid)
-					{
-						float tileRight = float((c + 1) * w);
-						out.hit = true;
-						out.coords = { c,rI };
-						out.newX = tileRight;
-						out.newY = box.y;
-						return out;
-					}
-				}
+				Real tileRight = Real((c + 1) * w);
+				out.hit = true;
+				out.coords = { c,rI };
+				out.newX = tileRight;
+				out.newY = box.y;
+				return out;
 			}
 			out.newX = rect.x + dx;
 			out.newY = rect.y;
@@ -403,65 +719,62 @@ namespace ssge
 	// Axis-separated sweep: move vertically by dy, collide with solids.
 	Level::SweepHit Level::sweepVertical(const SDL_FRect& rect, float dy) const
 	{
-		SweepHit out; out.hit = false;
+		return sweepVertical(Box<float>{ rect.x, rect.y, rect.w, rect.h }, dy);
+	}
+
+	template<typename Real>
+	Level::BasicSweepHit<Real> Level::sweepVertical(const Box<Real>& rect, Real dy) const
+	{
+		SSGE_PROFILE_ZONE("Level::sweepVertical");
+
+		BasicSweepHit<Real> out; out.hit = false;
+		const Real eps = nudge(Real());
 		const int w = blockSize.w, h = blockSize.h;
-		SDL_FRect box = rect;
-		box.w -= 1; // FIXME: This apparently fixes a faulty jumpstucky problem
+		Box<Real> box = rect;
+		box.w -= Real(1); // FIXME: This apparently fixes a faulty jumpstucky problem
 
 		int col0, col1, row0, row1;
-		rectToBlockSpan(box, col0, col1, row0, row1);
+		boxToBlockSpan(box, col0, col1, row0, row1);
 
-		if (dy > 0.f)
+		if (dy > Real(0))
 		{
-			float bottom0 = box.y + box.h;
-			float bottom1 = bottom0 + dy;
+			Real bottom0 = box.y + box.h;
+			Real bottom1 = bottom0 + dy;
 			// INCLUDE boundary tile at bottom0
-			int startRow = worldToRow(bottom0, h);
-			int endRow = worldToRow(bottom1 - EPS, h);
+			int startRow = cellOf(bottom0, h);
+			int endRow = cellOf(bottom1 - eps, h);
 
-			for (int rI = startRow; rI <= endRow; ++rI)
+			int rI, cI;
+			if (findFirstSolid(false, startRow, endRow, 1, col0, col1, rI, cI))
 			{
-				for (int cI = col0; cI <= col1; ++cI)
-				{
-					auto q = queryBlock(cI, rI);
-					if (q.coll == Block::Collision::Solid)
-					{
-						float tileTop = float(rI * h);
-						out.hit = true;
-						out.coords = { cI,rI };
-						out.newY = tileTop - box.h;
-						out.newX = box.x;
-						return out;
-					}
-				}
+				Real tileTop = Real(rI * h);
+				out.hit = true;
+				out.coords = { cI,rI };
+				out.newY = tileTop - box.h;
+				out.newX = box.x;
+				return out;
 			}
 			out.newX = rect.x;
 			out.newY = rect.y + dy;
 			return out;
 		}
-		else if (dy < 0.f)
+		else if (dy < Real(0))
 		{
-			float top0 = box.y;
-			float top1 = top0 + dy;
+			Real top0 = box.y;
+			Real top1 = top0 + dy;
 			// For up, include boundary with -EPS
-			int startRow = worldToRow(top0 - EPS, h);
-			int endRow = worldToRow(top1 + EPS, h);
+			int startRow = cellOf(top0 - eps, h);
+			int endRow = cellOf(top1 + eps, h);
 
-			for (int rI = startRow; rI >= endRow; --rI)
+			int rI, cI;
+			if (findFirstSolid(false, startRow, endRow, -1, col0, col1, rI, cI))
 			{
-				for (int cI = col0; cI <= col1; ++cI)
-				{
-					auto q = queryBlock(cI, rI);
-					if (q.coll == Block::Collision::Solid)
-					{
-						float tileBottom = float((rI + 1) * h);
-						out.hit = true;
-						out.coords = { cI,rI };
-						out.newY = tileBottom;
-						out.newX = box.x;
-						return out;
-					}
-				}
+				Real tileBottom = Real((rI + 1) * h);
+				out.hit = true;
+				out.coords = { cI,rI };
+				out.newY = tileBottom;
+				out.newX = box.x;
+				return out;
 			}
 			out.newX = rect.x;
 			out.newY = rect.y + dy;
@@ -473,6 +786,16 @@ namespace ssge
 		}
 	}
 
+	// Both physics scalars are built, whichever one SSGE_FIXED_PHYSICS picks
+	template bool Level::rectInWater(const Box<float>& r) const;
+	template bool Level::rectInWater(const Box<Fixed>& r) const;
+	template bool Level::rectInSolid(const Box<float>& r) const;
+	template bool Level::rectInSolid(const Box<Fixed>& r) const;
+	template Level::BasicSweepHit<float> Level::sweepHorizontal(const Box<float>& rect, float dx) const;
+	template Level::BasicSweepHit<Fixed> Level::sweepHorizontal(const Box<Fixed>& rect, Fixed dx) const;
+	template Level::BasicSweepHit<float> Level::sweepVertical(const Box<float>& rect, float dy) const;
+	template Level::BasicSweepHit<Fixed> Level::sweepVertical(const Box<Fixed>& rect, Fixed dy) const;
+
 	const SdlTexture& Level::getTilesetTexture() const
 	{
 		return tilesetTexture;
@@ -487,38 +810,93 @@ namespace ssge
 	{
 		this->tilesetTexture = std::move(SdlTexture);
 		tilesetMeta.inferColumnsFromTexture(tilesetTexture);
+		invalidateChunks();
 	}
 
 	bool Level::loadTileset(SDL_Renderer* renderer)
 	{
-		setTileset(SdlTexture(tilesetTexturePath.c_str(), renderer));
+		if (SDL_Surface* decoded = takeDecoded(0))
+			setTileset(SdlTexture(decoded, renderer));
+		else
+			setTileset(SdlTexture(tilesetTexturePath.c_str(), renderer));
 		return tilesetTexture.isValid();
 	}
 
 	bool Level::loadBackgrounds(SDL_Renderer* renderer)
 	{
 		bool success = true;
-		for (auto& background : backgrounds)
+		for (size_t i = 0; i < backgrounds.size(); i++)
 		{
-			success &= background.loadTexture(renderer);
+			auto& background = backgrounds[i];
+			if (SDL_Surface* decoded = takeDecoded(i + 1))
+			{
+				background.setTexture(SdlTexture(decoded, renderer));
+				success &= background.getTexture().isValid();
+			}
+			else
+			{
+				success &= background.loadTexture(renderer);
+			}
 		}
 		return success;
 	}
 
+	JobPool::TaskHandle Level::submitTextureLoading(JobPool& jobs, SDL_Renderer* renderer)
+	{
+		freeDecoded();
+		decodedImages.assign(backgrounds.size() + 1, nullptr);
+
+		// One task per image, they're big. Each writes only its own slot.
+		std::vector<JobPool::TaskHandle> decodes;
+		decodes.reserve(decodedImages.size());
+		for (size_t i = 0; i < decodedImages.size(); i++)
+		{
+			decodes.push_back(jobs.submit([this, i]() {
+				SSGE_PROFILE_ZONE("Level::decodeTexture");
+				std::string path = i == 0 ? tilesetTexturePath : backgrounds[i - 1].getPath();
+				decodedImages[i] = SdlTexture::loadSurface(path);
+			}));
+		}
+
+		// Uploading needs the renderer's thread
+		return jobs.submitToMainThread([this, renderer]() { loadTextures(renderer); }, decodes);
+	}
+
+	SDL_Surface* Level::takeDecoded(size_t index)
+	{
+		if (index >= decodedImages.size())
+			return nullptr;
+		SDL_Surface* decoded = decodedImages[index];
+		decodedImages[index] = nullptr;
+		return decoded;
+	}
+
+	void Level::freeDecoded()
+	{
+		for (SDL_Surface* decoded : decodedImages)
+		{
+			if (decoded)
+				SDL_FreeSurface(decoded);
+		}
+		decodedImages.clear();
+	}
+
 	bool Level::loadTextures(SDL_Renderer* renderer)
 	{
+		SSGE_PROFILE_ZONE("Level::loadTextures");
+
 		bool success = true;
 		success &= loadTileset(renderer);
 		success &= loadBackgrounds(renderer);
+		refreshChunks(renderer);
 		return success;
 	}
 
 	void Level::draw(DrawContext context) const
 	{
-		SDL_Renderer* renderer = context.getRenderer();
-		if (!renderer || !array) return;
+		SSGE_PROFILE_ZONE("Level::draw");
 
-		SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+		if (!context.getRenderer() || !array) return;
 
 		// Mitigate division by zero
 		if (!tilesetMeta.isValid())
@@ -573,51 +951,210 @@ namespace ssge
 						bkgWidth,
 						bkgHeight
 					};
-					SDL_RenderCopy(renderer, rawTexture, nullptr, &dest);
+					context.copy(rawTexture, nullptr, &dest);
 				}
 			}
 		}
 
 		if (tilesetTexture)
 		{
-			for (int r = topExtent; r < bottomExtent; ++r)
+			const int chunkLeft = leftExtent / CHUNK_SIZE;
+			const int chunkRight = (rightExtent + CHUNK_SIZE - 1) / CHUNK_SIZE;
+			const int chunkTop = topExtent / CHUNK_SIZE;
+			const int chunkBottom = (bottomExtent + CHUNK_SIZE - 1) / CHUNK_SIZE;
+
+			for (int chunkRow = chunkTop; chunkRow < chunkBottom; ++chunkRow)
 			{
-				for (int c = leftExtent; c < rightExtent; ++c)
+				for (int chunkCol = chunkLeft; chunkCol < chunkRight; ++chunkCol)
 				{
-					// Fetch the block
-					const Block& b = array[indexOf(r, c)];
-					if (b.type.isEmpty())
-						continue; // Empty block is invisible
-
-					// Get block type index
-					auto blockTypeIndex = b.getTypeIndex();
-					if (blockTypeIndex < 0 || blockTypeIndex >= MAX_BLOCK_DEFINITIONS)
-						continue; // Out of bounds. Skip.
-
-					// Get index of the tile that we should draw
-					auto blockTileIndex = blockDefinitions[blockTypeIndex].tileIndex;
+					const Chunk& chunk = chunks[chunkRow * chunkColumns + chunkCol];
+					const int col0 = chunkCol * CHUNK_SIZE;
+					const int row0 = chunkRow * CHUNK_SIZE;
+					const int col1 = std::min(col0 + CHUNK_SIZE, columns);
+					const int row1 = std::min(row0 + CHUNK_SIZE, rows);
+
+					if (!chunksSupported || chunk.dirty)
+					{ // Not rendered (yet), just the visible blocks of it
+						drawBlocks(context,
+							std::max(col0, leftExtent), std::min(col1, rightExtent),
+							std::max(row0, topExtent), std::min(row1, bottomExtent),
+							leftOffset, topOffset);
+						continue;
+					}
 
-					SDL_Rect src = tilesetMeta.makeRectForTile(blockTileIndex);
+					if (chunk.empty)
+						continue;
 
 					SDL_Rect dst{
-						c * blockSize.w - leftOffset,
-						r * blockSize.h - topOffset,
-						blockSize.w,
-						blockSize.h
+						col0 * blockSize.w - leftOffset,
+						row0 * blockSize.h - topOffset,
+						(col1 - col0) * blockSize.w,
+						(row1 - row0) * blockSize.h
 					};
 
-					SDL_RenderCopy(renderer, tilesetTexture, &src, &dst);
+					context.copy(chunk.texture, nullptr, &dst);
 				}
 			}
 		}
 	}
 
+	bool Level::isBlockVisible(const Block& block) const
+	{
+		if (block.type.isEmpty())
+			return false; // Empty block is invisible
+
+		auto blockTypeIndex = block.getTypeIndex();
+		if (blockTypeIndex < 0 || blockTypeIndex >= MAX_BLOCK_DEFINITIONS)
+			return false; // Out of bounds
+
+		return blockDefinitions[blockTypeIndex].tileIndex >= 0;
+	}
+
+	void Level::drawBlocks(const DrawContext& context, int col0, int col1, int row0, int row1, int left, int top) const
+	{
+		for (int r = row0; r < row1; ++r)
+		{
+			for (int c = col0; c < col1; ++c)
+			{
+				// Fetch the block
+				const Block& b = array[indexOf(r, c)];
+				if (!isBlockVisible(b))
+					continue;
+
+				// Get index of the tile that we should draw
+				auto blockTileIndex = blockDefinitions[b.getTypeIndex()].tileIndex;
+
+				SDL_Rect src = tilesetMeta.makeRectForTile(blockTileIndex);
+
+				SDL_Rect dst{
+					c * blockSize.w - left,
+					r * blockSize.h - top,
+					blockSize.w,
+					blockSize.h
+				};
+
+				context.copy(tilesetTexture, &src, &dst);
+			}
+		}
+	}
+
+	void Level::markChunkDirty(int col, int row)
+	{
+		chunks[(row / CHUNK_SIZE) * chunkColumns + col / CHUNK_SIZE].dirty = true;
+		anyChunkDirty = chunksSupported;
+	}
+
+	void Level::invalidateChunks()
+	{
+		for (Chunk& chunk : chunks)
+			chunk.dirty = true;
+		anyChunkDirty = chunksSupported && !chunks.empty();
+	}
+
+	void Level::refreshChunks(SDL_Renderer* renderer)
+	{
+		SSGE_PROFILE_ZONE("Level::refreshChunks");
+
+		if (!anyChunkDirty || !renderer || !array || !tilesetTexture || !tilesetMeta.isValid())
+			return;
+
+		if (!SDL_RenderTargetSupported(renderer))
+		{
+			std::cout << "Level: The renderer has no render targets. Drawing blocks one by one." << std::endl;
+			chunksSupported = false;
+			anyChunkDirty = false;
+			return;
+		}
+
+		// Tiles are copied as they are, the chunk gets blended when drawn.
+		// Blending them here too would apply their alpha twice.
+		SDL_BlendMode tilesetBlendMode = SDL_BLENDMODE_BLEND;
+		SDL_GetTextureBlendMode(tilesetTexture, &tilesetBlendMode);
+		SDL_SetTextureBlendMode(tilesetTexture, SDL_BLENDMODE_NONE);
+
+		SDL_Texture* previousTarget = SDL_GetRenderTarget(renderer);
+		Uint8 red, green, blue, alpha;
+		SDL_GetRenderDrawColor(renderer, &red, &green, &blue, &alpha);
+
+		anyChunkDirty = false;
+		for (int chunkRow = 0; chunkRow < chunkRows; ++chunkRow)
+		{
+			for (int chunkCol = 0; chunkCol < chunkColumns; ++chunkCol)
+			{
+				Chunk& chunk = chunks[chunkRow * chunkColumns + chunkCol];
+				if (!chunk.dirty)
+					continue;
+
+				const int col0 = chunkCol * CHUNK_SIZE;
+				const int row0 = chunkRow * CHUNK_SIZE;
+				if (!renderChunk(renderer, chunk,
+					col0, std::min(col0 + CHUNK_SIZE, columns),
+					row0, std::min(row0 + CHUNK_SIZE, rows)))
+				{ // Stays dirty, so it keeps drawing block by block
+					chunksSupported = false;
+					break;
+				}
+			}
+			if (!chunksSupported)
+				break;
+		}
+
+		SDL_SetRenderTarget(renderer, previousTarget);
+		SDL_SetRenderDrawColor(renderer, red, green, blue, alpha);
+		SDL_SetTextureBlendMode(tilesetTexture, tilesetBlendMode);
+	}
+
+	bool Level::renderChunk(SDL_Renderer* renderer, Chunk& chunk, int col0, int col1, int row0, int row1)
+	{
+		chunk.empty = true;
+		for (int r = row0; r < row1 && chunk.empty; ++r)
+			for (int c = col0; c < col1 && chunk.empty; ++c)
+				chunk.empty = !isBlockVisible(array[indexOf(r, c)]);
+
+		if (chunk.empty)
+		{ // Nothing to draw, keep the texture in case blocks show up again
+			chunk.dirty = false;
+			return true;
+		}
+
+		if (!chunk.texture)
+		{
+			SDL_Texture* texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888,
+				SDL_TEXTUREACCESS_TARGET, (col1 - col0) * blockSize.w, (row1 - row0) * blockSize.h);
+			if (!texture)
+			{
+				std::cout << "Level: SDL_CreateTexture error: " << SDL_GetError()
+					<< ". Drawing blocks one by one." << std::endl;
+				return false;
+			}
+			SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+			chunk.texture = texture;
+		}
+
+		if (SDL_SetRenderTarget(renderer, chunk.texture) != 0)
+		{
+			std::cout << "Level: SDL_SetRenderTarget error: " << SDL_GetError()
+				<< ". Drawing blocks one by one." << std::endl;
+			return false;
+		}
+
+		SDL_SetRenderDrawColor(renderer, 0, 0, 0, 0);
+		SDL_RenderClear(renderer);
+		drawBlocks(DrawContext(renderer), col0, col1, row0, row1,
+			col0 * blockSize.w, row0 * blockSize.h);
+
+		chunk.dirty = false;
+		return true;
+	}
+
 	// Level loader
 
 	Level::Loader::Loader(PassKey<GameWorld> pk)
 	{}
 	std::unique_ptr<Level> Level::Loader::loadLevel(const char* path)
 	{
+		SSGE_PROFILE_ZONE("Level::Loader::loadLevel");
+
 		do // gotophobia
 		{
 			if (!loadIni(path))
@@ -640,6 +1177,8 @@ namespace ssge
 			if (!parseGrid())
 				break; // goto failure
 
+			newLevel->buildCollisionLayer();
+
 			if (!parseSpawnList())
 				break; // goto failure
 
@@ -687,6 +1226,17 @@ namespace ssge
 			return nullptr;
 		}
 
+#if SSGE_FIXED_PHYSICS
+		// Fixed point physics can't reach further than this
+		if ((int64_t)columns * blockSize.w > Fixed::MAX_INT
+			|| (int64_t)rows * blockSize.h > Fixed::MAX_INT)
+		{
+			logError("Level is over " + std::to_string(Fixed::MAX_INT)
+				+ " pixels across, too big for fixed point physics");
+			return nullptr;
+		}
+#endif
+
 		auto newLevel = std::make_unique<Level>(columns, rows, blockSize);
 
 		newLevel->tilesetTexturePath=tilesetTexturePath;
@@ -713,6 +1263,13 @@ namespace ssge
 
 		newLevel->musicPath = getValue("SSGELEV1", "Music", "");
 
+		Activation& activation = newLevel->activation;
+		activation.enabled = getInt("SSGELEV1", "Activation", 1) != 0;
+		activation.spawnMargin = std::max(0.f, getFloat("SSGELEV1", "ActivationMargin", activation.spawnMargin));
+		activation.dormancyMargin = std::max(activation.spawnMargin,
+			getFloat("SSGELEV1", "DormancyMargin", activation.dormancyMargin));
+		activation.dormantInterval = std::max(0, getInt("SSGELEV1", "DormantStepInterval", activation.dormantInterval));
+
 		return true;
 	}
 	bool Level::Loader::parseBackgrounds()
@@ -744,6 +1301,7 @@ namespace ssge
 			newLevel->blockDefinitions[i].tileIndex = parseTileIndex(blockDefinition);
 			newLevel->blockDefinitions[i].collision = parseBlockCollision(blockDefinition);
 			newLevel->blockDefinitions[i].callback = parseCallbackName(blockDefinition);
+			newLevel->blockDefinitions[i].compiledCallback = Block::Callback::compile(newLevel->blockDefinitions[i].callback);
 		}
 		return true;
 	}
@@ -792,8 +1350,9 @@ namespace ssge
 				Spawn entry;
 				entry.where.x = (float)std::stoi(getValue("SpawnList", "Spawn" + std::to_string(i) + "X"));
 				entry.where.y = (float)std::stoi(getValue("SpawnList", "Spawn" + std::to_string(i) + "Y"));
-				entry.what = getValue("SpawnList", "Spawn" + std::to_string(i) + "Entity");
+				entry.what = ClassID(getValue("SpawnList", "Spawn" + std::to_string(i) + "Entity"));
 				entry.callback = getValue("SpawnList", "Spawn" + std::to_string(i) + "Callback");
+				entry.alwaysActive = getInt("SpawnList", "Spawn" + std::to_string(i) + "Always", 0) != 0;
 				spawnList.push_back(entry);
 			}
 
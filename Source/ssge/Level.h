@@ -5,9 +5,15 @@
 #include "DrawContext.h"
 #include "SdlTexture.h"
 #include "PassKey.h"
+#include "ClassID.h"
 #include <cmath>
 #include <memory>
 #include "IniFile.h"
+#include "Utilities.h"
+#include "Fixed.h"
+#include "JobPool.h"
+#include <cstdint>
+#include <type_traits>
 
 namespace ssge
 {
@@ -101,12 +107,41 @@ namespace ssge
 				static const Type EMPTY;
 			};
 
+			// A block callback compiled while loading. "Name>a,b<c^d" gives
+			// the opcode Name (interned) and the integer after each marker.
+			// Game code hooks handlers to opcodes with BlockCallbacks.
+			struct Callback
+			{
+				enum Operand
+				{
+					Right, // >
+					Comma, // ,
+					Left,  // <
+					Up,    // ^
+					TOTAL_OPERANDS
+				};
+
+				ClassID opcode; // None = no callback
+				int operands[TOTAL_OPERANDS] = { 0, 0, 0, 0 };
+				uint8_t present = 0; // Bit per Operand found
+
+				bool has(Operand which) const { return (present & (1u << which)) != 0; }
+				int get(Operand which, int fallback) const { return has(which) ? operands[which] : fallback; }
+
+				// Parses a callback string (without the '@')
+				static Callback compile(const std::string& source);
+
+				// What blocks without a callback have
+				static const Callback NONE;
+			};
+
 			struct Definition
 			{
 				// Tile to draw. -1 = Don't draw
 				int tileIndex = -1;
 				Collision collision = Collision::Air;
 				std::string callback;
+				Callback compiledCallback; // callback, parsed once
 				//TODO: Harden with PassKey
 				Definition() = default;
 			};
@@ -171,6 +206,17 @@ namespace ssge
 			}
 		};
 
+		// What forEachBlockInRect hands out. Same as BlockQuery, but
+		// plain data: the callback comes compiled (never null).
+		struct BlockVisit
+		{
+			Level::Block::Coords coords;
+			Level::Block::Type type = Level::Block::Type::EMPTY;
+			Level::Block::Collision coll = Level::Block::Collision::Air;
+			const Level::Block::Callback* callback = &Level::Block::Callback::NONE;
+			bool insideLevel = false;
+		};
+
 		struct BlockQuery
 		{
 			Level::Block::Coords coords;     // where is the block on the grid
@@ -182,13 +228,54 @@ namespace ssge
 			bool insideLevel = false;
 		};
 
-		struct SweepHit
+		// Block writes held back until a merge point, so that entities
+		// stepped on several threads all see the level as it was when the
+		// step began. Writes are tagged with the writer's order (its
+		// position among the entities) and merged by it, so the result
+		// doesn't depend on which thread ran what.
+		class WriteJournal
+		{
+		public:
+			struct Write
+			{
+				uint32_t order;
+				uint32_t sequence; // Keeps one writer's writes in order
+				Block::Coords coords;
+				int type;
+			};
+
+		private:
+			std::vector<Write> writes;
+			uint32_t order = 0;
+
+		public:
+			// Writes recorded from now on belong to this writer
+			void setOrder(uint32_t order) { this->order = order; }
+			void record(Block::Coords coords, int type) {
+				writes.push_back(Write{ order, (uint32_t)writes.size(), coords, type });
+			}
+			const std::vector<Write>& getWrites() const { return writes; }
+			void clear() { writes.clear(); }
+			void reserve(size_t count) { writes.reserve(count); }
+		};
+
+		// A box in level space, in the scalar physics steps with
+		// (PhysicsReal, see Fixed.h). SDL_FRect is the float one.
+		template<typename Real>
+		struct Box
+		{
+			Real x, y, w, h;
+		};
+
+		template<typename Real>
+		struct BasicSweepHit
 		{
 			bool hit = false;
 			Level::Block::Coords coords;      // solid block we hit
-			float newX = 0.f;                 // resolved x (after axis move)
-			float newY = 0.f;                 // resolved y (after axis move)
+			Real newX = 0;                    // resolved x (after axis move)
+			Real newY = 0;                    // resolved y (after axis move)
 		};
+		using SweepHit = BasicSweepHit<float>;
 
 		class Background
 		{
@@ -250,6 +337,65 @@ namespace ssge
 		// Flat array allocated with columns * rows elements.
 		Block* array{ nullptr };
 
+		// Collision of every cell (Block::Collision), same layout as array.
+		// Built from blockDefinitions once loaded, setBlockType keeps it
+		// current.
+		std::vector<uint8_t> collisionLayer;
+
+		// Solid cells as bits, 64 to a word, so sweeps and probes test a
+		// whole run of cells at once. By row (bit per column) for
+		// horizontal sweeps, by column (bit per row) for vertical ones,
+		// water by row for rectInWater. Kept along with collisionLayer.
+		int rowWords = 0;    // Words per row mask
+		int columnWords = 0; // Words per column mask
+		std::vector<uint64_t> solidByRow;
+		std::vector<uint64_t> solidByColumn;
+		std::vector<uint64_t> waterByRow;
+
+		// The blocks pre-rendered CHUNK_SIZE x CHUNK_SIZE to a texture, so
+		// a frame blits a few chunks instead of every visible block.
+		// setBlockType marks a chunk dirty, refreshChunks renders it again.
+		// Dirty chunks draw block by block until then.
+		struct Chunk
+		{
+			SdlTexture texture; // Render target, made once there's something to draw
+			bool dirty = true;
+			bool empty = false; // No visible blocks, nothing to blit
+		};
+		std::vector<Chunk> chunks;
+		int chunkColumns = 0;
+		int chunkRows = 0;
+		bool anyChunkDirty = true;
+		bool chunksSupported = true; // False if the renderer can't do render targets
+
+		void markChunkDirty(int col, int row);
+		bool renderChunk(SDL_Renderer* renderer, Chunk& chunk, int col0, int col1, int row0, int row1);
+		bool isBlockVisible(const Block& block) const;
+		// Draws blocks [col0, col1) x [row0, row1), block (0,0) at (-left, -top)
+		void drawBlocks(const DrawContext& context, int col0, int col1, int row0, int row1, int left, int top) const;
+
+		// Block type index, invalid ones treated as 0
+		static int definitionOf(int typeIndex) {
+			return (typeIndex < 0 || typeIndex >= MAX_BLOCK_DEFINITIONS) ? 0 : typeIndex;
+		}
+		void buildCollisionLayer();
+		void setCollision(int col, int row, Block::Collision collision);
+		Block::Collision outOfBoundsCollision(int col, int row) const;
+
+		// Any cell in the span with collision what? byRow holds the
+		// in-level cells, the OOB policy the rest.
+		bool spanHas(Block::Collision what, const std::vector<uint64_t>& byRow,
+			int col0, int col1, int row0, int row1) const;
+
+		// First solid cell walking from..to by step (along columns if
+		// horizontal, else rows) across lines line0..line1. Within the
+		// first solid column/row, the lowest line wins.
+		bool findFirstSolid(bool horizontal, int from, int to, int step,
+			int line0, int line1, int& along, int& line) const;
+
+		template<typename Real>
+		void boxToBlockSpan(const Box<Real>& r, int& col0, int& col1, int& row0, int& row1) const;
+
 		// Outside-collision policy per side/corner
 	public:
 		Block::Collision throughTopLeft{ Block::Collision::DeathIfFullyOutside };
@@ -262,6 +408,16 @@ namespace ssge
 		Block::Collision throughBottomRight{ Block::Collision::DeathIfFullyOutside };
 		int nextSection;
 
+		// Activation regions around the view, in screens ([SSGELEV1])
+		struct Activation
+		{
+			bool enabled = true;         // Activation=0 steps and spawns everything
+			float spawnMargin = 0.5f;    // ActivationMargin: spawns appear this close
+			float dormancyMargin = 1.0f; // DormancyMargin: entities farther out go dormant
+			int dormantInterval = 0;     // DormantStepInterval: step them every N ticks (0 = never)
+		};
+		Activation activation;
+
 		// Ctor / Dtor
 		Level(int columns, int rows, SDL_Rect blockSize, SdlTexture tileset = SdlTexture());
 		~Level();
@@ -283,6 +439,16 @@ namespace ssge
 		Block* getBlockAt(SDL_FPoint point);
 		const Block* getConstBlockAt(SDL_FPoint point) const;
 
+		// Changes a block's type. False if coords are out of bounds.
+		bool setBlockType(Block::Coords coords, int type);
+
+		// Applies the writes of all journals, lowest order first (so the
+		// highest order wins a block written twice). merged is scratch.
+		void applyJournals(const std::vector<WriteJournal>& journals, std::vector<WriteJournal::Write>& merged);
+
+		// Feeds the block grid into a state hash
+		void hashState(StateHash& hash) const;
+
 		Block::Collision getCollisionAt(SDL_FPoint positionInLevel) const;
 		Block::Collision getBlockCollisionType(const Block& block) const;
 		std::string getBlockCallbackString(const Block& block) const;
@@ -298,17 +464,83 @@ namespace ssge
         // Query a block (with OOB policy)
         BlockQuery queryBlock(int col, int row) const;
 
+		// Collision of a cell (with OOB policy). Cheap: one byte lookup.
+		Block::Collision getCollision(int col, int row) const
+		{
+			if (col >= 0 && col < columns && row >= 0 && row < rows)
+				return (Block::Collision)collisionLayer[row * columns + col];
+			return outOfBoundsCollision(col, row);
+		}
+		// Collision of the cell at a position in the level (with OOB policy)
+		Block::Collision getCollision(SDL_FPoint positionInLevel) const
+		{
+			return getCollision(worldToCol(std::floor(positionInLevel.x), blockSize.w),
+				worldToRow(std::floor(positionInLevel.y), blockSize.h));
+		}
+
+		// Same as queryBlock, callback as an ID
+		BlockVisit visitBlock(int col, int row) const
+		{
+			BlockVisit visit;
+			visit.coords = { col, row };
+			visit.coll = getCollision(col, row);
+			visit.insideLevel = col >= 0 && col < columns && row >= 0 && row < rows;
+			if (visit.insideLevel)
+			{
+				visit.type = array[row * columns + col].type;
+				visit.callback = &blockDefinitions[definitionOf(visit.type.getIndex())].compiledCallback;
+			}
+			return visit;
+		}
+
+		// Calls visit(const BlockVisit&) for every block that overlaps
+		// rect, row by row. A visitor returning bool stops the walk by
+		// returning false. Never allocates.
+		template<typename Visitor>
+		void forEachBlockInRect(const SDL_FRect& rect, Visitor&& visit) const
+		{
+			int col0, col1, row0, row1;
+			rectToBlockSpan(rect, col0, col1, row0, row1);
+			for (int row = row0; row <= row1; row++)
+			{
+				for (int col = col0; col <= col1; col++)
+				{
+					BlockVisit block = visitBlock(col, row);
+					if constexpr (std::is_same<decltype(visit(block)), bool>::value)
+					{
+						if (!visit(block))
+							return;
+					}
+					else
+					{
+						visit(block);
+					}
+				}
+			}
+		}
+
 		// Query a block at specific position in level
 		BlockQuery queryBlock(SDL_FPoint positionInLevel) const;
 
         // Is any overlapped tile "water"?
         bool rectInWater(const SDL_FRect& r) const;
+        template<typename Real>
+        bool rectInWater(const Box<Real>& r) const;
+
+        // Is any overlapped tile solid?
+        bool rectInSolid(const SDL_FRect& r) const;
+        template<typename Real>
+        bool rectInSolid(const Box<Real>& r) const;
 
         // Axis-separated sweep: move horizontally by dx, collide with solids.
         SweepHit sweepHorizontal(const SDL_FRect& rect, float dx) const;
+        template<typename Real>
+        BasicSweepHit<Real> sweepHorizontal(const Box<Real>& rect, Real dx) const;
 
         // Axis-separated sweep: move vertically by dy, collide with solids.
         SweepHit sweepVertical(const SDL_FRect& rect, float dy) const;
+        template<typename Real>
+        BasicSweepHit<Real> sweepVertical(const Box<Real>& rect, Real dy) const;
 
 		const SdlTexture& getTilesetTexture() const;
 		const TilesetMeta getTilesetMeta() const;
@@ -317,9 +549,28 @@ namespace ssge
 		bool loadTileset(SDL_Renderer* renderer);
 		bool loadBackgrounds(SDL_Renderer* renderer);
 		bool loadTextures(SDL_Renderer* renderer);
+		// Decodes the tileset and background images as tasks on jobs,
+		// then runs loadTextures on the main thread (which renders) once
+		// they are all decoded. Wait for the returned task before drawing.
+		JobPool::TaskHandle submitTextureLoading(JobPool& jobs, SDL_Renderer* renderer);
+
+	private:
+		std::vector<SDL_Surface*> decodedImages; // Tileset, then backgrounds
+		SDL_Surface* takeDecoded(size_t index);
+		void freeDecoded();
+
+	public:
 
 		void draw(DrawContext context) const; // conservative draw (no templates)
 
+		static const int CHUNK_SIZE = 16; // Blocks per chunk side
+
+		// Renders the dirty chunks again. Call on the render thread.
+		void refreshChunks(SDL_Renderer* renderer);
+		bool hasDirtyChunks() const { return anyChunkDirty; }
+		// Marks every chunk dirty (new tileset, lost render targets)
+		void invalidateChunks();
+
 		class Loader : public IniFile
 		{
 			std::unique_ptr<Level> newLevel; // Level we're making
@@ -344,8 +595,9 @@ namespace ssge
 			struct Spawn
 			{
 				SDL_FPoint where = { 0,0 };
-				std::string what;
+				ClassID what; // Interned while loading
 				std::string callback;
+				bool alwaysActive = false; // SpawnNAlways: spawned at load, never dormant
 			};
 		private:
 			std::vector<Spawn> spawnList;
@@ -14,7 +14,8 @@ MenuContext::MenuContext(
 	MenusAccess menus,
 	CurrentSceneAccess currentScene,
 	GameWorldAccess gameWorld,
-	LevelAccess level
+	LevelAccess level,
+	EventsAccess events
 ) :
 	engine(engine),
 	game(game),
@@ -25,5 +26,6 @@ MenuContext::MenuContext(
 	menus(menus),
 	currentScene(currentScene),
 	gameWorld(gameWorld),
-	level(level)
+	level(level),
+	events(events)
 {}
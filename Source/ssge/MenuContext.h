@@ -19,6 +19,7 @@ namespace ssge
         CurrentSceneAccess currentScene;
         GameWorldAccess gameWorld;
         LevelAccess level;
+        EventsAccess events;
 
         explicit MenuContext(
             PassKey<Engine> pk,
@@ -31,7 +32,8 @@ namespace ssge
             MenusAccess menus,
             CurrentSceneAccess currentScene,
             GameWorldAccess gameWorld,
-            LevelAccess level
+            LevelAccess level,
+            EventsAccess events
         );
     };
 }
@@ -5,6 +5,7 @@
 #include "SDL.h"
 #include "SDL_ttf.h"
 #include "InputSet.h"
+#include "Profiler.h"
 
 using namespace ssge;
 
@@ -373,53 +374,8 @@ MenuHeader::~MenuHeader()
     clearItems();
 }
 
-// Draw a UTF-8 string centered at xCenter,y with an optional shadow.
-// Returns the drawn text width/height via outW/outH (nullable).
-static void DrawTextCenteredShadowed(
-    SDL_Renderer* renderer,
-    TTF_Font* font,
-    const char* text,
-    int xCenter,
-    int y,
-    SDL_Color color,
-    bool drawShadow,
-    SDL_Color shadowColor,
-    int shadowOffsetPx,
-    int* outW = nullptr,
-    int* outH = nullptr)
-{
-    if (!renderer || !font || !text) return;
-
-    // Measure first to compute the centered x
-    int w = 0, h = 0;
-    if (TTF_SizeUTF8(font, text, &w, &h) != 0) {
-        // If measure fails, bail gracefully
-        return;
-    }
-    int x = xCenter - (w / 2);
-
-    // Small lambda to render one colored copy
-    auto renderOnce = [&](SDL_Color c, int dx, int dy) {
-        SDL_Surface* srf = TTF_RenderUTF8_Blended(font, text, c);
-        if (!srf) return;
-        SDL_Texture* tex = SDL_CreateTextureFromSurface(renderer, srf);
-        SDL_FreeSurface(srf);
-        if (!tex) return;
-        SDL_Rect dst{ x + dx, y + dy, w, h };
-        SDL_RenderCopy(renderer, tex, nullptr, &dst);
-        SDL_DestroyTexture(tex);
-        };
-
-    if (drawShadow) renderOnce(shadowColor, shadowOffsetPx, shadowOffsetPx);
-    renderOnce(color, 0, 0);
-
-    if (outW) *outW = w;
-    if (outH) *outH = h;
-}
-
 void MenuManager::drawText(DrawContext& dc, SDL_Color color, int height, std::string text)
 {
-    SDL_Renderer* r = dc.getRenderer();
     // choose your menu font (store it somewhere central)
     TTF_Font* font = dc.getFont(); // or however you access it right now
 
@@ -429,11 +385,11 @@ void MenuManager::drawText(DrawContext& dc, SDL_Color color, int height, std::st
     const SDL_Rect bounds = dc.getBounds(); // screen or viewport
     const int xCenter = bounds.x + bounds.w / 2;
 
-    DrawTextCenteredShadowed(
-        r, font, text.c_str(),
+    // Measured and rendered by whoever owns the renderer
+    dc.drawTextCentered(
+        font, text,
         xCenter, height,
         color,
-        /*drawShadow=*/true,
         shadow, /*shadowOffsetPx=*/2
     );
 }
@@ -743,7 +699,7 @@ void MenuManager::step(MenuContext& context)
             break;
 
         case MenuCommand::SAVE_AND_BACK:
-            context.game.saveSettings();
+            context.events.post(SaveSettingsEvent{});
             [[fallthrough]]; // Fallthrough OK
         case MenuCommand::GO_BACK:
             // Go to the previous menu
@@ -792,7 +748,7 @@ void MenuManager::step(MenuContext& context)
             }
             break;
         case MenuCommand::SAVE_CONFIG:
-            context.game.saveSettings();
+            context.events.post(SaveSettingsEvent{});
             break;
         default:
             // This is for any command number not covered previously
@@ -813,9 +769,10 @@ void MenuManager::step(MenuContext& context)
 
 void MenuManager::draw(DrawContext& context)
 {
+    SSGE_PROFILE_ZONE("MenuManager::draw");
+
     if (!currentMenu) return;
 
-    SDL_Renderer* renderer = context.getRenderer();
     const SDL_Rect bounds = context.getBounds();
 
     // Allegro: al_get_font_line_height(Breakenzi::Font)
@@ -844,12 +801,7 @@ void MenuManager::draw(DrawContext& context)
                  bounds.w,
                  menuTextHeight + 2 * margin };
 
-    // Save/restore draw color around fills
-    Uint8 pr, pg, pb, pa;
-    SDL_GetRenderDrawColor(renderer, &pr, &pg, &pb, &pa);
-    SDL_SetRenderDrawColor(renderer, cMenuBackground.r, cMenuBackground.g, cMenuBackground.b, cMenuBackground.a);
-    SDL_RenderFillRect(renderer, &bg);
-    SDL_SetRenderDrawColor(renderer, pr, pg, pb, pa);
+    context.fillRect(bg, cMenuBackground);
 
     // Title
     drawText(context, cMenuTitle, top + linePadding / 2, currentMenu->getTitle());
@@ -868,11 +820,8 @@ void MenuManager::draw(DrawContext& context)
         // Selected row highlight (Allegro: al_draw_filled_rectangle)
         if (i == itemIndex)
         {
-            SDL_GetRenderDrawColor(renderer, &pr, &pg, &pb, &pa);
-            SDL_SetRenderDrawColor(renderer, cItemCursor.r, cItemCursor.g, cItemCursor.b, cItemCursor.a);
             SDL_Rect sel{ bounds.x, currentHeight, bounds.w, lineHeight };
-            SDL_RenderFillRect(renderer, &sel);
-            SDL_SetRenderDrawColor(renderer, pr, pg, pb, pa);
+            context.fillRect(sel, cItemCursor);
         }
 
         // Determine item color (matches your logic)
@@ -0,0 +1,69 @@
+#include "ObjectPool.h"
+
+using namespace ssge;
+
+ObjectPool::ObjectPool(size_t size, size_t alignment)
+{
+	// Every block has to fit a free list link and stay aligned
+	if (size < sizeof(FreeBlock))
+		size = sizeof(FreeBlock);
+	if (alignment < alignof(FreeBlock))
+		alignment = alignof(FreeBlock);
+	blockSize = (size + alignment - 1) / alignment * alignment;
+}
+
+ObjectPool::~ObjectPool()
+{
+	// Pools live until the program exits. If something is still out
+	// there, leave the memory to the OS rather than pull it from under it.
+	if (used)
+		return;
+
+	for (void* chunk : chunks)
+		::operator delete(chunk);
+}
+
+void ObjectPool::grow(size_t blocks)
+{
+	if (blocks < MIN_CHUNK_BLOCKS)
+		blocks = MIN_CHUNK_BLOCKS;
+
+	char* chunk = static_cast<char*>(::operator new(blocks * blockSize));
+	chunks.push_back(chunk);
+
+	// Thread the new blocks onto the free list, first block first out
+	for (size_t i = blocks; i-- > 0; )
+	{
+		FreeBlock* block = reinterpret_cast<FreeBlock*>(chunk + i * blockSize);
+		block->next = freeList;
+		freeList = block;
+	}
+
+	capacity += blocks;
+}
+
+void* ObjectPool::allocate()
+{
+	if (!freeList)
+		grow(capacity); // Double up
+
+	FreeBlock* block = freeList;
+	freeList = block->next;
+	used++;
+	return block;
+}
+
+void ObjectPool::release(void* block)
+{
+	FreeBlock* freed = static_cast<FreeBlock*>(block);
+	freed->next = freeList;
+	freeList = freed;
+	used--;
+}
+
+void ObjectPool::reserve(size_t count)
+{
+	size_t available = capacity - used;
+	if (available < count)
+		grow(count - available);
+}
@@ -0,0 +1,88 @@
+#pragma once
+#include <cstddef>
+#include <new>
+#include <vector>
+
+namespace ssge
+{
+	// Free list of equally sized blocks, carved out of bigger chunks.
+	//
+	// Allocating and releasing pop and push the free list. Chunks are only
+	// allocated when the pool runs dry (or when reserving), and are never
+	// given back, so once a pool has grown to its high water mark it stops
+	// allocating altogether. Not thread-safe: entities and everything they
+	// own are created and destroyed on the simulation thread.
+	class ObjectPool
+	{
+		struct FreeBlock
+		{
+			FreeBlock* next;
+		};
+
+		static const size_t MIN_CHUNK_BLOCKS = 32;
+
+		size_t blockSize;
+		FreeBlock* freeList = nullptr;
+		std::vector<void*> chunks;
+		size_t capacity = 0; // Blocks in all chunks
+		size_t used = 0;     // Blocks handed out
+
+		void grow(size_t blocks);
+
+	public:
+		ObjectPool(size_t size, size_t alignment);
+		ObjectPool(const ObjectPool& toCopy) = delete;
+		ObjectPool(ObjectPool&& toMove) = delete;
+		~ObjectPool();
+
+		void* allocate();
+		void release(void* block);
+
+		// Makes sure count more blocks can be allocated without growing
+		void reserve(size_t count);
+
+		size_t getCapacity() const { return capacity; }
+		size_t getUsed() const { return used; }
+	};
+
+	// Mixin that makes new/delete of T go through a pool of its own:
+	//
+	//     class Bubble : public Entity, public Pooled<Bubble>
+	//
+	// make_unique<Bubble>() and deleting through an Entity pointer then
+	// reuse pooled blocks. Classes deriving from T are of a different size
+	// and fall back to the regular heap.
+	template<typename T>
+	class Pooled
+	{
+		static ObjectPool& pool()
+		{
+			static ObjectPool instance(sizeof(T), alignof(T));
+			return instance;
+		}
+
+	public:
+		static void* operator new(size_t size)
+		{
+			if (size != sizeof(T) || alignof(T) > alignof(std::max_align_t))
+				return ::operator new(size);
+			return pool().allocate();
+		}
+
+		static void operator delete(void* block, size_t size)
+		{
+			if (!block)
+				return;
+			if (size != sizeof(T) || alignof(T) > alignof(std::max_align_t))
+				::operator delete(block);
+			else
+				pool().release(block);
+		}
+
+		// Makes room for count more objects up front
+		static void reservePool(size_t count) { pool().reserve(count); }
+
+		static size_t getPoolCapacity() { return pool().getCapacity(); }
+		static size_t getPoolUsed() { return pool().getUsed(); }
+	};
+}
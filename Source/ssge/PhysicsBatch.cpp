@@ -0,0 +1,126 @@
+#include "PhysicsBatch.h"
+
+using namespace ssge;
+
+void PhysicsBatch::clear()
+{
+	bodies.clear();
+	flags.clear();
+	sideX.clear();
+	sideY.clear();
+	accX.clear();
+	accY.clear();
+	decX.clear();
+	decY.clear();
+	maxHor.clear();
+	maxUp.clear();
+	maxDown.clear();
+	gravity.clear();
+	jumpSpeed.clear();
+	velX.clear();
+	velY.clear();
+	jumpTimer.clear();
+}
+
+void PhysicsBatch::reserve(size_t count)
+{
+	bodies.reserve(count);
+	flags.reserve(count);
+	sideX.reserve(count);
+	sideY.reserve(count);
+	accX.reserve(count);
+	accY.reserve(count);
+	decX.reserve(count);
+	decY.reserve(count);
+	maxHor.reserve(count);
+	maxUp.reserve(count);
+	maxDown.reserve(count);
+	gravity.reserve(count);
+	jumpSpeed.reserve(count);
+	velX.reserve(count);
+	velY.reserve(count);
+	jumpTimer.reserve(count);
+}
+
+void PhysicsBatch::add(Entity::Physics& body)
+{
+	const auto& abilities = body.abilities;
+	if (!abilities.physicsEnabled())
+		return;
+
+	// Picks up velocity game code set since the last tick
+	body.takeOverChanges();
+
+	bodies.push_back(&body);
+	flags.push_back((uint32_t)abilities.bits);
+	sideX.push_back(PhysicsReal(body.side.x));
+	sideY.push_back(PhysicsReal(body.side.y));
+	accX.push_back(abilities.acc.x);
+	accY.push_back(abilities.acc.y);
+	decX.push_back(abilities.dec.x);
+	decY.push_back(abilities.dec.y);
+	maxHor.push_back(abilities.maxSpeedHor);
+	maxUp.push_back(abilities.maxSpeedUp);
+	maxDown.push_back(abilities.maxSpeedDown);
+	gravity.push_back(abilities.gravity);
+	jumpSpeed.push_back(abilities.jumpSpeed);
+	velX.push_back(body.exactVelocity.x);
+	velY.push_back(body.exactVelocity.y);
+	jumpTimer.push_back(PhysicsReal((float)body.jumpTimer));
+}
+
+// The velocity phase over whole arrays. The compiler has to know that the
+// arrays don't overlap (__restrict, ivdep), or the loop won't vectorize.
+static void integrateArrays(size_t count,
+	const uint32_t* __restrict flags,
+	const PhysicsReal* __restrict sideX, const PhysicsReal* __restrict sideY,
+	const PhysicsReal* __restrict accX, const PhysicsReal* __restrict accY,
+	const PhysicsReal* __restrict decX, const PhysicsReal* __restrict decY,
+	const PhysicsReal* __restrict maxHor, const PhysicsReal* __restrict maxUp,
+	const PhysicsReal* __restrict maxDown, const PhysicsReal* __restrict gravity,
+	const PhysicsReal* __restrict jumpSpeed,
+	PhysicsReal* __restrict velX, PhysicsReal* __restrict velY, PhysicsReal* __restrict jumpTimer)
+{
+#if defined(__clang__)
+#pragma clang loop vectorize(assume_safety)
+#elif defined(__GNUC__)
+#pragma GCC ivdep
+#elif defined(_MSC_VER)
+#pragma loop(ivdep)
+#endif
+	for (size_t i = 0; i < count; i++)
+	{
+		PhysicsBatch::integrateBody(flags[i], sideX[i], sideY[i],
+			accX[i], accY[i], decX[i], decY[i],
+			maxHor[i], maxUp[i], maxDown[i], gravity[i], jumpSpeed[i],
+			velX[i], velY[i], jumpTimer[i]);
+	}
+}
+
+void PhysicsBatch::integrate()
+{
+	integrate(0, bodies.size());
+}
+
+void PhysicsBatch::integrate(size_t begin, size_t end)
+{
+	integrateArrays(end - begin, flags.data() + begin,
+		sideX.data() + begin, sideY.data() + begin,
+		accX.data() + begin, accY.data() + begin,
+		decX.data() + begin, decY.data() + begin,
+		maxHor.data() + begin, maxUp.data() + begin, maxDown.data() + begin,
+		gravity.data() + begin, jumpSpeed.data() + begin,
+		velX.data() + begin, velY.data() + begin, jumpTimer.data() + begin);
+}
+
+void PhysicsBatch::scatter()
+{
+	for (size_t i = 0; i < bodies.size(); i++)
+	{
+		Entity::Physics& body = *bodies[i];
+		body.exactVelocity.x = velX[i];
+		body.exactVelocity.y = velY[i];
+		body.jumpTimer = toFloat(jumpTimer[i]);
+		body.publish();
+	}
+}
@@ -0,0 +1,151 @@
+#pragma once
+#include "Entity.h"
+#include "Fixed.h"
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace ssge
+{
+	// Structure-of-arrays working set for the physics velocity phase.
+	//
+	// Every tick EntityManager gathers the bodies that have physics enabled,
+	// runs acceleration, deceleration, clamping, jumping and gravity for all
+	// of them in one loop, and scatters velocities back before the per-body
+	// level sweeps. integrateBody only uses selects, no branches, so that
+	// loop vectorizes.
+	//
+	// Everything runs on PhysicsReal, float or 16.16 Fixed (Fixed.h).
+	//
+	// Entity::Physics stays the state game code reads and writes between
+	// ticks; this only holds what the velocity phase needs while it runs.
+	class PhysicsBatch
+	{
+		std::vector<Entity::Physics*> bodies;
+
+		std::vector<uint32_t> flags; // Abilities::Flag bits
+		std::vector<PhysicsReal> sideX;
+		std::vector<PhysicsReal> sideY;
+		std::vector<PhysicsReal> accX;
+		std::vector<PhysicsReal> accY;
+		std::vector<PhysicsReal> decX;
+		std::vector<PhysicsReal> decY;
+		std::vector<PhysicsReal> maxHor;
+		std::vector<PhysicsReal> maxUp;
+		std::vector<PhysicsReal> maxDown;
+		std::vector<PhysicsReal> gravity;
+		std::vector<PhysicsReal> jumpSpeed;
+
+		std::vector<PhysicsReal> velX;
+		std::vector<PhysicsReal> velY;
+		std::vector<PhysicsReal> jumpTimer;
+
+	public:
+		void clear();
+		void reserve(size_t count);
+
+		// Gathers a body (skipped if its physics are disabled)
+		void add(Entity::Physics& body);
+
+		// Runs the velocity phase for every gathered body
+		void integrate();
+		// Same for the bodies in [begin, end), so workers can split it
+		void integrate(size_t begin, size_t end);
+
+		// Writes velocities and jump timers back to the bodies
+		void scatter();
+
+		size_t size() const { return bodies.size(); }
+
+		// One body's velocity phase. Entity::Physics uses it for single
+		// bodies, so batched and unbatched stepping agree.
+		static inline void integrateBody(uint32_t flags, PhysicsReal sideX, PhysicsReal sideY,
+			PhysicsReal accX, PhysicsReal accY, PhysicsReal decX, PhysicsReal decY,
+			PhysicsReal maxHor, PhysicsReal maxUp, PhysicsReal maxDown,
+			PhysicsReal gravity, PhysicsReal jumpSpeed,
+			PhysicsReal& velX, PhysicsReal& velY, PhysicsReal& jumpTimer)
+		{
+			using Flag = Entity::Physics::Abilities::Flag;
+			const bool horzMove = (flags & (uint32_t)Flag::EnableHorizontalMove) != 0u;
+			const bool vertMove = (flags & (uint32_t)Flag::EnableVerticalMove) != 0u;
+			const PhysicsReal zero = 0;
+			const PhysicsReal one = 1;
+
+			PhysicsReal vx = velX;
+			PhysicsReal vy = velY;
+			PhysicsReal timer = jumpTimer;
+
+			// Every candidate is computed up front and pick() chooses.
+			// With ?: the compiler moves the math back under branches.
+
+			// Move horizontally
+			PhysicsReal moved = vx + sideX * accX;
+			PhysicsReal clamped = signOf(moved) * maxHor;
+			moved = pick(absOf(moved) > maxHor, clamped, moved);
+			vx = pick(horzMove, moved, vx);
+
+			// Move vertically
+			moved = vy + sideY * accY;
+			clamped = signOf(moved) * maxUp;
+			moved = pick((moved < zero) & (-moved > maxUp), clamped, moved);
+			clamped = signOf(moved) * maxDown;
+			moved = pick(moved > maxDown, clamped, moved);
+			vy = pick(vertMove, moved, vy);
+
+			// Decelerate
+			PhysicsReal slowed = vx - signOf(vx) * decX;
+			slowed = pick(decX > absOf(vx), zero, slowed);
+			vx = pick((sideX == zero) | (accX == zero), slowed, vx);
+
+			slowed = vy - signOf(vy) * decY;
+			slowed = pick(decY > absOf(vy), zero, slowed);
+			bool slowY = ((sideY == zero) | (accY == zero)) & (timer == zero) & (gravity == zero);
+			vy = pick(slowY, slowed, vy);
+
+			// Jump while the timer lasts, otherwise fall
+			bool jumping = timer > zero;
+			bool jumpApplies = jumping & (vy >= -jumpSpeed);
+			PhysicsReal fallen = vy + gravity;
+			clamped = signOf(fallen) * maxDown;
+			fallen = pick(fallen > maxDown, clamped, fallen);
+			timer = pick(jumpApplies, timer - one, timer);
+			PhysicsReal notJumping = pick(!jumping & (sideY == zero), fallen, vy);
+			vy = pick(jumpApplies, -jumpSpeed, notJumping);
+
+			velX = vx;
+			velY = vy;
+			jumpTimer = timer;
+		}
+
+	private:
+		// Branchless sign (-1, 0 or 1)
+		static inline float signOf(float x)
+		{
+			return (float)(x > 0.f) - (float)(x < 0.f);
+		}
+		static inline Fixed signOf(Fixed x)
+		{
+			return Fixed::fromRaw(((int32_t)(x > Fixed()) - (int32_t)(x < Fixed())) * Fixed::ONE);
+		}
+
+		// Branchless condition ? whenTrue : whenFalse
+		static inline float pick(bool condition, float whenTrue, float whenFalse)
+		{
+			uint32_t mask = 0u - (uint32_t)condition;
+			uint32_t t, f;
+			std::memcpy(&t, &whenTrue, sizeof(t));
+			std::memcpy(&f, &whenFalse, sizeof(f));
+			uint32_t picked = (t & mask) | (f & ~mask);
+			float result;
+			std::memcpy(&result, &picked, sizeof(result));
+			return result;
+		}
+		static inline Fixed pick(bool condition, Fixed whenTrue, Fixed whenFalse)
+		{
+			uint32_t mask = 0u - (uint32_t)condition;
+			uint32_t picked = ((uint32_t)whenTrue.getRaw() & mask) | ((uint32_t)whenFalse.getRaw() & ~mask);
+			return Fixed::fromRaw((int32_t)picked);
+		}
+	};
+}
@@ -0,0 +1,502 @@
+#include "Profiler.h"
+
+#if SSGE_PROFILER
+
+#include "DrawContext.h"
+#include <SDL_ttf.h>
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+
+using namespace ssge;
+
+Profiler* Profiler::active = nullptr;
+SDL_atomic_t Profiler::tracing = { 0 };
+
+Profiler::Profiler(PassKey<Engine> pk)
+{
+	frequency = SDL_GetPerformanceFrequency();
+	if (frequency == 0) frequency = 1;
+
+	active = this;
+}
+
+Profiler::~Profiler()
+{
+	finishTrace();
+
+	if (active == this)
+		active = nullptr;
+}
+
+void Profiler::beginFrame(PassKey<Engine> pk)
+{
+	frameStart = SDL_GetPerformanceCounter();
+	tracedFrame = isTracing();
+
+	recording = visible;
+	if (!recording)
+		return;
+
+	Frame& frame = frames[writeIndex];
+	frame.nodes.clear();
+	frame.droppedZones = 0;
+	frame.start = frameStart;
+	frame.duration = 0;
+
+	// Node 0 is the frame itself, zones hang under it
+	Node root;
+	root.name = "Frame";
+	root.depth = -1;
+	root.calls = 1;
+	root.started = frame.start;
+	frame.nodes.push_back(root);
+
+	current = 0;
+	ownerThread = SDL_ThreadID();
+	inFrame = true;
+}
+
+void Profiler::endFrame(PassKey<Engine> pk)
+{
+	uint64_t end = SDL_GetPerformanceCounter();
+
+	if (tracedFrame)
+	{
+		tracedFrame = false;
+		addTraceEvent("Frame", frameStart, end);
+
+		if (traceFramesLeft > 0 && --traceFramesLeft == 0)
+			finishTrace();
+	}
+
+	if (!inFrame)
+		return;
+
+	inFrame = false;
+
+	Frame& frame = frames[writeIndex];
+	frame.duration = end - frame.start;
+	frame.nodes[0].total = frame.duration;
+
+	writeIndex = (writeIndex + 1) % HISTORY;
+	finishedFrames++;
+}
+
+void Profiler::discardFrame(PassKey<Engine> pk)
+{
+	inFrame = false;
+	tracedFrame = false;
+}
+
+bool Profiler::isOverlayVisible() const
+{
+	return visible;
+}
+
+void Profiler::setOverlayVisible(bool visible)
+{
+	// History from before it was hidden is stale
+	if (visible && !this->visible)
+		finishedFrames = 0;
+
+	this->visible = visible;
+}
+
+void Profiler::toggleOverlay()
+{
+	setOverlayVisible(!visible);
+}
+
+void Profiler::setDrawStats(PassKey<Engine> pk, uint32_t drawCalls, uint32_t quads)
+{
+	SDL_AtomicSet(&this->drawCalls, (int)drawCalls);
+	SDL_AtomicSet(&this->quads, (int)quads);
+}
+
+int Profiler::findOrAddChild(Frame& frame, int parent, const char* name)
+{
+	// Zone names are string literals, comparing pointers is enough
+	for (int child = frame.nodes[parent].firstChild; child != -1;
+		child = frame.nodes[child].nextSibling)
+	{
+		if (frame.nodes[child].name == name)
+			return child;
+	}
+
+	if ((int)frame.nodes.size() >= MAX_NODES)
+		return -1;
+
+	int index = (int)frame.nodes.size();
+	Node node;
+	node.name = name;
+	node.parent = parent;
+	node.depth = frame.nodes[parent].depth + 1;
+	frame.nodes.push_back(node);
+
+	Node& parentNode = frame.nodes[parent];
+	if (parentNode.lastChild == -1)
+		parentNode.firstChild = index;
+	else
+		frame.nodes[parentNode.lastChild].nextSibling = index;
+	parentNode.lastChild = index;
+
+	return index;
+}
+
+bool Profiler::beginZone(const char* name)
+{
+	Profiler* profiler = active;
+	if (!profiler || !profiler->inFrame || !profiler->recording)
+		return false;
+	if (SDL_ThreadID() != profiler->ownerThread)
+		return false;
+
+	Frame& frame = profiler->frames[profiler->writeIndex];
+	int node = profiler->findOrAddChild(frame, profiler->current, name);
+	if (node == -1)
+	{
+		frame.droppedZones++;
+		return false;
+	}
+
+	frame.nodes[node].calls++;
+	frame.nodes[node].started = SDL_GetPerformanceCounter();
+	profiler->current = node;
+	return true;
+}
+
+void Profiler::endZone()
+{
+	Profiler* profiler = active;
+	if (!profiler || !profiler->inFrame)
+		return;
+
+	Frame& frame = profiler->frames[profiler->writeIndex];
+	Node& node = frame.nodes[profiler->current];
+	node.total += SDL_GetPerformanceCounter() - node.started;
+	profiler->current = node.parent;
+}
+
+bool Profiler::isTracing()
+{
+	return SDL_AtomicGet(&tracing) != 0;
+}
+
+void Profiler::traceZone(const char* name, uint64_t start)
+{
+	if (Profiler* profiler = active)
+		profiler->addTraceEvent(name, start, SDL_GetPerformanceCounter());
+}
+
+void Profiler::nameThread(const char* name)
+{
+	Profiler* profiler = active;
+	if (!profiler)
+		return;
+
+	SDL_threadID thread = SDL_ThreadID();
+
+	SDL_AtomicLock(&profiler->traceLock);
+	bool found = false;
+	for (auto& entry : profiler->traceThreads)
+	{
+		if (entry.thread == thread)
+		{
+			entry.name = name;
+			found = true;
+		}
+	}
+	if (!found)
+		profiler->traceThreads.push_back(TraceThread{ thread, name });
+	SDL_AtomicUnlock(&profiler->traceLock);
+}
+
+bool Profiler::startTrace(PassKey<Engine> pk, const std::string& path, int frames)
+{
+	if (isTracing() || path.empty())
+		return false;
+
+	SDL_AtomicLock(&traceLock);
+	traceEvents.clear();
+	traceEvents.reserve(65536);
+	droppedTraceEvents = 0;
+	tracePath = path;
+	traceStart = SDL_GetPerformanceCounter();
+	traceFramesLeft = frames > 0 ? frames : 0;
+	SDL_AtomicUnlock(&traceLock);
+
+	SDL_AtomicSet(&tracing, 1);
+
+	std::cout << "Tracing ";
+	if (frames > 0) std::cout << frames << " frames";
+	else std::cout << "until exit";
+	std::cout << " into " << path << std::endl;
+
+	return true;
+}
+
+void Profiler::stopTrace(PassKey<Engine> pk)
+{
+	finishTrace();
+}
+
+void Profiler::addTraceEvent(const char* name, uint64_t start, uint64_t end)
+{
+	SDL_AtomicLock(&traceLock);
+	// Re-check under the lock, the trace may have just been written
+	if (isTracing())
+	{
+		if (traceEvents.size() < MAX_TRACE_EVENTS)
+			traceEvents.push_back(TraceEvent{ name, SDL_ThreadID(), start, end - start });
+		else
+			droppedTraceEvents++;
+	}
+	SDL_AtomicUnlock(&traceLock);
+}
+
+// Zone names are string literals, but quotes would still break the JSON
+static void writeJsonString(std::ostream& out, const char* text)
+{
+	out << '"';
+	for (const char* c = text; *c; c++)
+	{
+		if (*c == '"' || *c == '\\') out << '\\';
+		out << *c;
+	}
+	out << '"';
+}
+
+void Profiler::finishTrace()
+{
+	if (!SDL_AtomicCAS(&tracing, 1, 0))
+		return;
+
+	// Take everything out, then write without holding up other threads
+	std::vector<TraceEvent> events;
+	std::vector<TraceThread> threads;
+	std::string path;
+	size_t dropped = 0;
+
+	SDL_AtomicLock(&traceLock);
+	events.swap(traceEvents);
+	threads = traceThreads;
+	path = tracePath;
+	dropped = droppedTraceEvents;
+	SDL_AtomicUnlock(&traceLock);
+
+	std::ofstream out(path, std::ios::out | std::ios::trunc);
+	if (!out)
+	{
+		std::cout << "Couldn't write trace " << path << std::endl;
+		return;
+	}
+
+	// Timestamps are microseconds from the start of the trace
+	auto toUS = [this](uint64_t counterTicks) {
+		return (double)counterTicks * 1000000.0 / (double)frequency;
+	};
+
+	out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+	out << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,"
+		"\"args\":{\"name\":\"ssge\"}}";
+	for (const auto& thread : threads)
+	{
+		out << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":"
+			<< (unsigned long long)thread.thread << ",\"args\":{\"name\":";
+		writeJsonString(out, thread.name);
+		out << "}}";
+	}
+
+	out.setf(std::ios::fixed);
+	out.precision(3);
+	for (const auto& event : events)
+	{
+		out << ",\n{\"name\":";
+		writeJsonString(out, event.name);
+		out << ",\"cat\":\"ssge\",\"ph\":\"X\",\"pid\":1,\"tid\":"
+			<< (unsigned long long)event.thread
+			<< ",\"ts\":" << toUS(event.start - traceStart)
+			<< ",\"dur\":" << toUS(event.duration) << "}";
+	}
+	out << "\n],\"otherData\":{\"droppedEvents\":" << dropped << "}}\n";
+
+	std::cout << "Trace written to " << path << " (" << events.size()
+		<< " events";
+	if (dropped) std::cout << ", " << dropped << " dropped";
+	std::cout << ")" << std::endl;
+}
+
+double Profiler::toMS(uint64_t counterTicks) const
+{
+	return (double)counterTicks * 1000.0 / (double)frequency;
+}
+
+void Profiler::aggregate(int frameCount) const
+{
+	rows.clear();
+	rows.push_back(Row()); // Root
+	rows[0].depth = -1;
+
+	// Newest first, so rows are ordered the way the latest frame ran
+	for (int age = 1; age <= frameCount; age++)
+	{
+		const Frame& frame = frames[(writeIndex - age + HISTORY) % HISTORY];
+
+		rowOfNode.assign(frame.nodes.size(), 0);
+		// Nodes are created after their parents, so one pass does it
+		for (size_t i = 1; i < frame.nodes.size(); i++)
+		{
+			const Node& node = frame.nodes[i];
+			int parentRow = rowOfNode[node.parent];
+
+			int row = -1;
+			for (int child = rows[parentRow].firstChild; child != -1;
+				child = rows[child].nextSibling)
+			{
+				if (rows[child].name == node.name)
+				{
+					row = child;
+					break;
+				}
+			}
+			if (row == -1)
+			{
+				row = (int)rows.size();
+				Row newRow;
+				newRow.name = node.name;
+				newRow.parent = parentRow;
+				newRow.depth = rows[parentRow].depth + 1;
+				rows.push_back(newRow);
+
+				if (rows[parentRow].lastChild == -1)
+					rows[parentRow].firstChild = row;
+				else
+					rows[rows[parentRow].lastChild].nextSibling = row;
+				rows[parentRow].lastChild = row;
+			}
+
+			rows[row].calls += node.calls;
+			rows[row].total += node.total;
+			rows[row].worst = std::max(rows[row].worst, node.total);
+			rowOfNode[i] = row;
+		}
+	}
+}
+
+void Profiler::drawOverlay(DrawContext& context, double frameBudgetMS) const
+{
+	if (!visible)
+		return;
+
+	const SDL_Color panelColor = { 0, 0, 0, 176 };
+	const SDL_Color textColor = { 255, 255, 255, 255 };
+	const SDL_Color dimColor = { 160, 160, 160, 255 };
+	const SDL_Color shadowColor = { 0, 0, 0, 255 };
+	const SDL_Color budgetColor = { 255, 255, 255, 128 };
+
+	const int graphBarWidth = 2;
+	const int graphWidth = HISTORY * graphBarWidth;
+	const int graphHeight = 80;
+	const int padding = 8;
+	const int left = 8;
+	const int top = 8;
+	const int width = graphWidth + padding * 2;
+
+	TTF_Font* font = context.getFont();
+	const int lineHeight = font ? TTF_FontLineSkip(font) : 0;
+
+	int frameCount = (int)std::min<uint64_t>(finishedFrames, AVERAGED_FRAMES);
+	aggregate(frameCount);
+
+	// Zone rows in call order (depth first)
+	order.clear();
+	for (int row = rows[0].firstChild; row != -1;)
+	{
+		order.push_back(row);
+		if (rows[row].firstChild != -1)
+		{
+			row = rows[row].firstChild;
+			continue;
+		}
+		while (row != -1 && rows[row].nextSibling == -1)
+			row = rows[row].parent > 0 ? rows[row].parent : -1;
+		if (row != -1)
+			row = rows[row].nextSibling;
+	}
+
+	const int textLines = font ? 2 + (int)order.size() : 0;
+	const int height = padding * 3 + textLines * lineHeight + graphHeight;
+	context.fillRect(SDL_Rect{ left, top, width, height }, panelColor);
+
+	int y = top + padding;
+	if (font)
+	{
+		char line[128];
+
+		// Header: whole frame
+		double sumMS = 0, worstMS = 0;
+		for (int age = 1; age <= frameCount; age++)
+		{
+			double ms = toMS(frames[(writeIndex - age + HISTORY) % HISTORY].duration);
+			sumMS += ms;
+			worstMS = std::max(worstMS, ms);
+		}
+		std::snprintf(line, sizeof(line), "Frame %6.2f ms  max %6.2f ms  (F3)",
+			frameCount ? sumMS / frameCount : 0.0, worstMS);
+		context.drawText(font, line, left + padding, y, textColor, shadowColor, 1);
+		y += lineHeight;
+
+		// Renderer calls for the quads of the last frame
+		std::snprintf(line, sizeof(line), "Draw calls %d  quads %d",
+			SDL_AtomicGet(&drawCalls), SDL_AtomicGet(&quads));
+		context.drawText(font, line, left + padding, y, dimColor, shadowColor, 1);
+		y += lineHeight;
+
+		// Zones: average per frame, calls per frame
+		for (int row : order)
+		{
+			const Row& r = rows[row];
+			double avgMS = frameCount ? toMS(r.total) / frameCount : 0.0;
+			double calls = frameCount ? (double)r.calls / frameCount : 0.0;
+
+			context.drawText(font, r.name, left + padding + r.depth * 16, y,
+				textColor, shadowColor, 1);
+
+			std::snprintf(line, sizeof(line), "%6.2f ms  max %6.2f  x%.0f",
+				avgMS, toMS(r.worst), calls);
+			context.drawText(font, line, left + width / 2, y,
+				dimColor, shadowColor, 1);
+			y += lineHeight;
+		}
+	}
+
+	// Frame time graph, oldest on the left. Top of the graph is 2x budget.
+	y += padding;
+	const int graphLeft = left + padding;
+	const int graphBottom = y + graphHeight;
+	const double graphMS = frameBudgetMS > 0 ? frameBudgetMS * 2 : 33.3;
+
+	int shown = (int)std::min<uint64_t>(finishedFrames, HISTORY);
+	for (int age = shown; age >= 1; age--)
+	{
+		double ms = toMS(frames[(writeIndex - age + HISTORY) % HISTORY].duration);
+		int barHeight = (int)(ms / graphMS * graphHeight);
+		barHeight = std::clamp(barHeight, 1, graphHeight);
+
+		SDL_Color barColor = { 64, 224, 64, 255 };
+		if (ms > frameBudgetMS * 1.5) barColor = SDL_Color{ 240, 64, 64, 255 };
+		else if (ms > frameBudgetMS) barColor = SDL_Color{ 240, 200, 64, 255 };
+
+		int x = graphLeft + (HISTORY - age) * graphBarWidth;
+		context.fillRect(SDL_Rect{ x, graphBottom - barHeight, graphBarWidth, barHeight },
+			barColor);
+	}
+
+	// Budget line
+	context.fillRect(SDL_Rect{ graphLeft, graphBottom - graphHeight / 2, graphWidth, 1 },
+		budgetColor);
+}
+
+#endif
@@ -0,0 +1,215 @@
+#pragma once
+#include <SDL.h>
+#include <cstdint>
+#include <vector>
+#include <string>
+#include "PassKey.h"
+
+// Builds the profiler in. Pass -DSSGE_PROFILER=0 to compile it out:
+// zones then expand to nothing and Profiler becomes an empty shell.
+#ifndef SSGE_PROFILER
+#define SSGE_PROFILER 1
+#endif
+
+namespace ssge
+{
+	class Engine;
+	class DrawContext;
+
+#if SSGE_PROFILER
+
+	// Built-in hierarchical profiler.
+	//
+	// Code marks zones with SSGE_PROFILE_ZONE("Name") at the top of a scope.
+	// Zones nest, and repeated zones under the same parent are merged
+	// (a thousand sweeps in a frame are one node with a thousand calls).
+	// Every frame's call tree goes into a ring buffer of HISTORY frames.
+	//
+	// Only the thread that began the frame records. Zones hit by any other
+	// thread, outside of a frame, or while recording is off cost a check.
+	//
+	// Tracing is separate: while a trace runs, every zone on every thread
+	// (loading included) becomes a Chrome trace-event, written as JSON that
+	// chrome://tracing and Perfetto open.
+	class Profiler
+	{
+	public:
+		static const int HISTORY = 240;        // Frames kept for the graph
+		static const int AVERAGED_FRAMES = 60; // Frames averaged per zone
+		static const int MAX_NODES = 1024;     // Distinct zones per frame
+
+		struct Node
+		{
+			const char* name = nullptr;
+			int parent = -1;
+			int firstChild = -1;
+			int lastChild = -1;
+			int nextSibling = -1;
+			int depth = 0;
+			uint32_t calls = 0;
+			uint64_t total = 0;   // Performance counter ticks
+			uint64_t started = 0; // While open
+		};
+
+		struct Frame
+		{
+			std::vector<Node> nodes;
+			uint64_t start = 0;
+			uint64_t duration = 0;
+			uint32_t droppedZones = 0; // Over MAX_NODES
+		};
+
+	private:
+		// Zones find the profiler through this (there's only one Engine)
+		static Profiler* active;
+
+		Frame frames[HISTORY];
+		int writeIndex = 0;
+		uint64_t finishedFrames = 0;
+
+		bool visible = false;   // Overlay toggle
+		bool recording = false; // Latched from visible when a frame begins
+		bool inFrame = false;
+		int current = -1;       // Open zone in frames[writeIndex]
+		SDL_threadID ownerThread = 0;
+		uint64_t frequency = 1;
+
+		// Overlay scratch (aggregated zones), kept to avoid reallocating
+		struct Row
+		{
+			const char* name = nullptr;
+			int parent = -1;
+			int firstChild = -1;
+			int lastChild = -1;
+			int nextSibling = -1;
+			int depth = 0;
+			uint64_t calls = 0;
+			uint64_t total = 0;
+			uint64_t worst = 0;
+		};
+		mutable std::vector<Row> rows;
+		mutable std::vector<int> rowOfNode;
+		mutable std::vector<int> order; // Rows as drawOverlay lists them
+
+		// Last replayed frame, set by whichever thread renders
+		mutable SDL_atomic_t drawCalls{};
+		mutable SDL_atomic_t quads{};
+
+		// Trace capture
+		struct TraceEvent
+		{
+			const char* name;
+			SDL_threadID thread;
+			uint64_t start;
+			uint64_t duration;
+		};
+		struct TraceThread
+		{
+			SDL_threadID thread;
+			const char* name;
+		};
+		static const size_t MAX_TRACE_EVENTS = 1000000; // About 32 MB
+		static SDL_atomic_t tracing;
+		SDL_SpinLock traceLock = 0; // Guards everything below
+		std::vector<TraceEvent> traceEvents;
+		std::vector<TraceThread> traceThreads;
+		size_t droppedTraceEvents = 0;
+		std::string tracePath;
+		uint64_t traceStart = 0;
+		int traceFramesLeft = 0;  // 0 = until stopTrace
+		uint64_t frameStart = 0;
+		bool tracedFrame = false; // Frame began while tracing
+
+		void addTraceEvent(const char* name, uint64_t start, uint64_t end);
+		void finishTrace();
+
+		int findOrAddChild(Frame& frame, int parent, const char* name);
+		void aggregate(int frameCount) const;
+		double toMS(uint64_t counterTicks) const;
+
+	public:
+		Profiler(PassKey<Engine> pk);
+		Profiler(const Profiler& toCopy) = delete;
+		Profiler(Profiler&& toMove) = delete;
+		~Profiler();
+
+		// Frame boundaries. Zones are only recorded between these.
+		void beginFrame(PassKey<Engine> pk);
+		void endFrame(PassKey<Engine> pk);
+		// Ends the frame without keeping it (nothing happened in it)
+		void discardFrame(PassKey<Engine> pk);
+
+		bool isOverlayVisible() const;
+		void setOverlayVisible(bool visible);
+		void toggleOverlay();
+
+		// Draws per-zone milliseconds and a frame time graph
+		void drawOverlay(DrawContext& context, double frameBudgetMS) const;
+
+		// What drawing the last frame took (see RenderBatch)
+		void setDrawStats(PassKey<Engine> pk, uint32_t drawCalls, uint32_t quads);
+
+		// Starts capturing a trace. After the given number of frames
+		// (0 = until stopTrace) it's written to path.
+		bool startTrace(PassKey<Engine> pk, const std::string& path, int frames);
+		// Writes the trace now if one is running
+		void stopTrace(PassKey<Engine> pk);
+		// Names the calling thread in traces
+		static void nameThread(const char* name);
+
+		// Used by ProfileZone
+		static bool beginZone(const char* name);
+		static void endZone();
+		static bool isTracing();
+		static void traceZone(const char* name, uint64_t start);
+	};
+
+	// RAII zone: opens on construction, closes when the scope ends
+	class ProfileZone
+	{
+		const char* name;
+		uint64_t traceStart;
+		bool began;
+	public:
+		explicit ProfileZone(const char* name) :
+			name(name),
+			traceStart(Profiler::isTracing() ? SDL_GetPerformanceCounter() : 0),
+			began(Profiler::beginZone(name))
+		{}
+		ProfileZone(const ProfileZone& toCopy) = delete;
+		~ProfileZone()
+		{
+			if (began) Profiler::endZone();
+			if (traceStart) Profiler::traceZone(name, traceStart);
+		}
+	};
+
+#define SSGE_PROFILE_JOIN2(a, b) a##b
+#define SSGE_PROFILE_JOIN(a, b) SSGE_PROFILE_JOIN2(a, b)
+#define SSGE_PROFILE_ZONE(name) \
+	::ssge::ProfileZone SSGE_PROFILE_JOIN(ssgeProfileZone, __LINE__)(name)
+
+#else
+
+	// Profiler compiled out: same interface, nothing inside
+	class Profiler
+	{
+	public:
+		Profiler(PassKey<Engine> pk) {}
+		void beginFrame(PassKey<Engine> pk) {}
+		void endFrame(PassKey<Engine> pk) {}
+		void discardFrame(PassKey<Engine> pk) {}
+		bool isOverlayVisible() const { return false; }
+		void setOverlayVisible(bool visible) {}
+		void toggleOverlay() {}
+		void drawOverlay(DrawContext& context, double frameBudgetMS) const {}
+		void setDrawStats(PassKey<Engine> pk, uint32_t drawCalls, uint32_t quads) {}
+		bool startTrace(PassKey<Engine> pk, const std::string& path, int frames) { return false; }
+		void stopTrace(PassKey<Engine> pk) {}
+		static void nameThread(const char* name) {}
+	};
+
+#define SSGE_PROFILE_ZONE(name) ((void)0)
+
+#endif
+}
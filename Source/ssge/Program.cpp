@@ -2,6 +2,7 @@
 #include "IGame.h"
 #include "Engine.h"
 #include "PassKey.h"
+#include "EngineOptions.h"
 #include <memory>
 
 using namespace ssge;
@@ -13,8 +14,15 @@ int ssge::Program::run(IGame& game, int argc, char* argv[])
     if (alreadyRunning)return -1;
     alreadyRunning = true;
 
+    // Parse command line switches
+    EngineOptions options;
+    if (!options.parse(argc, argv))
+    { // Don't guess what the user wanted
+        return -1; // Return failure code
+    }
+
     // Create engine with the game
-    auto engine = std::make_unique<Engine>(PassKey<Program>(), game);
+    auto engine = std::make_unique<Engine>(PassKey<Program>(), game, options);
 
     // Initialize the engine
     if (engine->init(PassKey<Program>()))
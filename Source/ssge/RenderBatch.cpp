@@ -0,0 +1,163 @@
+#include "RenderBatch.h"
+#include <cmath>
+#include <iostream>
+#include <utility>
+
+using namespace ssge;
+
+RenderBatch::RenderBatch(bool enabled)
+	: enabled(enabled && SSGE_RENDER_GEOMETRY)
+{
+}
+
+void RenderBatch::begin(SDL_Renderer* renderer)
+{
+	this->renderer = renderer;
+	pending.clear();
+	stats = Stats();
+}
+
+bool RenderBatch::add(const FramePacket::Command& command)
+{
+	using Kind = FramePacket::Command::Kind;
+
+	if (command.kind != Kind::Copy && command.kind != Kind::CopyEx)
+		return false;
+
+	stats.quads++;
+
+	// Whole render target copies stay as they are
+	if (!enabled || !command.hasDst)
+		return false;
+
+	if (!pending.empty() && pending.front()->texture != command.texture)
+		flush();
+
+	pending.push_back(&command);
+	return true;
+}
+
+void RenderBatch::flush()
+{
+	if (pending.empty())
+		return;
+
+	// One quad is one call either way
+	if (pending.size() == 1 || !drawGeometry())
+	{
+		for (const FramePacket::Command* command : pending)
+			stats.drawCalls += (uint32_t)FramePacket::execute(renderer, *command);
+	}
+
+	pending.clear();
+}
+
+bool RenderBatch::drawGeometry()
+{
+#if SSGE_RENDER_GEOMETRY
+	using Kind = FramePacket::Command::Kind;
+
+	SDL_Texture* texture = pending.front()->texture;
+
+	int width = 0, height = 0;
+	if (SDL_QueryTexture(texture, nullptr, nullptr, &width, &height) != 0
+		|| width <= 0 || height <= 0)
+		return false;
+	const float inverseWidth = 1.f / (float)width;
+	const float inverseHeight = 1.f / (float)height;
+
+	// Copies use the texture's alpha mod, CopyEx sets it (see execute).
+	// Here it goes into the vertex colors instead.
+	Uint8 startAlpha = 255;
+	SDL_GetTextureAlphaMod(texture, &startAlpha);
+	Uint8 alpha = startAlpha;
+
+	vertices.clear();
+	indices.clear();
+
+	for (const FramePacket::Command* command : pending)
+	{
+		const SDL_Rect& dst = command->dst;
+		const bool ex = command->kind == Kind::CopyEx;
+		if (ex)
+			alpha = command->alpha;
+
+		float u0 = 0.f, v0 = 0.f, u1 = 1.f, v1 = 1.f;
+		if (command->hasSrc)
+		{
+			u0 = (float)command->src.x * inverseWidth;
+			v0 = (float)command->src.y * inverseHeight;
+			u1 = (float)(command->src.x + command->src.w) * inverseWidth;
+			v1 = (float)(command->src.y + command->src.h) * inverseHeight;
+		}
+		if (ex && (command->flip & SDL_FLIP_HORIZONTAL))
+			std::swap(u0, u1);
+		if (ex && (command->flip & SDL_FLIP_VERTICAL))
+			std::swap(v0, v1);
+
+		// Corners around the rotation center, clockwise from top-left
+		const float centerX = command->hasCenter ? (float)command->center.x : dst.w * 0.5f;
+		const float centerY = command->hasCenter ? (float)command->center.y : dst.h * 0.5f;
+		float xs[4] = { -centerX, dst.w - centerX, dst.w - centerX, -centerX };
+		float ys[4] = { -centerY, -centerY, dst.h - centerY, dst.h - centerY };
+		if (ex && command->angle != 0.0)
+		{
+			// Clockwise in degrees, like SDL_RenderCopyEx
+			const double radians = command->angle * (M_PI / 180.0);
+			const float c = (float)std::cos(radians);
+			const float s = (float)std::sin(radians);
+			for (int i = 0; i < 4; i++)
+			{
+				float x = xs[i];
+				xs[i] = x * c - ys[i] * s;
+				ys[i] = x * s + ys[i] * c;
+			}
+		}
+
+		const SDL_Color color = { 255, 255, 255, alpha };
+		const float us[4] = { u0, u1, u1, u0 };
+		const float vs[4] = { v0, v0, v1, v1 };
+		const int first = (int)vertices.size();
+		for (int i = 0; i < 4; i++)
+		{
+			SDL_Vertex vertex;
+			vertex.position = SDL_FPoint{ dst.x + centerX + xs[i], dst.y + centerY + ys[i] };
+			vertex.color = color;
+			vertex.tex_coord = SDL_FPoint{ us[i], vs[i] };
+			vertices.push_back(vertex);
+		}
+
+		const int quad[6] = { 0, 1, 2, 0, 2, 3 };
+		for (int corner : quad)
+			indices.push_back(first + corner);
+	}
+
+	// The vertex colors carry the alpha, don't let the mod apply twice
+	if (startAlpha != 255)
+		SDL_SetTextureAlphaMod(texture, 255);
+
+	int result = SDL_RenderGeometry(renderer, texture,
+		vertices.data(), (int)vertices.size(),
+		indices.data(), (int)indices.size());
+
+	if (result != 0)
+	{
+		if (startAlpha != 255)
+			SDL_SetTextureAlphaMod(texture, startAlpha);
+
+		std::cout << "RenderBatch: SDL_RenderGeometry error: " << SDL_GetError()
+			<< ". Copying quads one by one." << std::endl;
+		enabled = false;
+		return false;
+	}
+
+	// Leave the mod as the copies would have
+	if (alpha != 255)
+		SDL_SetTextureAlphaMod(texture, alpha);
+
+	stats.drawCalls++;
+	return true;
+#else
+	return false;
+#endif
+}
@@ -0,0 +1,72 @@
+#pragma once
+#include <SDL.h>
+#include <cstdint>
+#include <vector>
+#include "FramePacket.h"
+
+// SDL_RenderGeometry came with SDL 2.0.18. Older SDL (the XP toolchain)
+// copies every quad on its own.
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+#define SSGE_RENDER_GEOMETRY 1
+#else
+#define SSGE_RENDER_GEOMETRY 0
+#endif
+
+namespace ssge
+{
+	// Turns runs of textured quads into single renderer calls.
+	//
+	// FramePacket::replay hands it every Copy and CopyEx. Quads that share
+	// a texture pile up as vertices and go out in one SDL_RenderGeometry
+	// call once the texture changes or something else (a fill, text) has
+	// to be drawn, so the drawing order stays as recorded.
+	//
+	// Without SDL_RenderGeometry (old SDL, a renderer that refuses it, or
+	// --no-batch) the quads are copied one by one, like before.
+	class RenderBatch
+	{
+	public:
+		// What the last replay cost
+		struct Stats
+		{
+			uint32_t drawCalls = 0; // Calls into the renderer
+			uint32_t quads = 0;     // Copies and CopyExes drawn
+		};
+
+	private:
+		SDL_Renderer* renderer = nullptr;
+		bool enabled = true;
+		Stats stats;
+
+		// Quads waiting for the next flush, all of the same texture.
+		// They point into the packet being replayed.
+		std::vector<const FramePacket::Command*> pending;
+
+#if SSGE_RENDER_GEOMETRY
+		// Scratch for SDL_RenderGeometry, kept to avoid reallocating
+		std::vector<SDL_Vertex> vertices;
+		std::vector<int> indices;
+#endif
+
+		// Draws the pending quads with one call, false if it can't
+		bool drawGeometry();
+
+	public:
+		explicit RenderBatch(bool enabled = true);
+
+		// Starts a replay on renderer and zeroes the stats
+		void begin(SDL_Renderer* renderer);
+
+		// Takes a Copy or CopyEx for the batch. False if it has to be
+		// executed right away (anything else, or no destination rect).
+		bool add(const FramePacket::Command& command);
+
+		// Draws whatever is pending
+		void flush();
+
+		// Counts calls made next to the batch (fills, text)
+		void countDrawCalls(int calls) { stats.drawCalls += (uint32_t)calls; }
+
+		const Stats& getStats() const { return stats; }
+	};
+}
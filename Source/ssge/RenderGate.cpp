@@ -0,0 +1,175 @@
+#include "RenderGate.h"
+#include "SdlTexture.h"
+#include <iostream>
+
+using namespace ssge;
+
+RenderGate* RenderGate::active = nullptr;
+
+RenderGate::RenderGate(PassKey<Engine> pk)
+{
+}
+
+RenderGate::~RenderGate()
+{
+	stop();
+}
+
+bool RenderGate::begin(PassKey<Engine> pk)
+{
+	if (threaded)
+		return true;
+
+	mutex = SDL_CreateMutex();
+	finished = SDL_CreateCond();
+	if (!mutex || !finished)
+	{
+		std::cout << "RenderGate: " << SDL_GetError() << std::endl;
+		if (finished) SDL_DestroyCond(finished);
+		if (mutex) SDL_DestroyMutex(mutex);
+		finished = nullptr;
+		mutex = nullptr;
+		return false;
+	}
+
+	ownerThread = SDL_ThreadID();
+	lastPublished = 0;
+	threaded = true;
+
+	// From now on SdlTextures are retired rather than destroyed
+	active = this;
+	SdlTexture::setDestroyHook(&RenderGate::retireTexture);
+
+	return true;
+}
+
+void RenderGate::end(PassKey<Engine> pk)
+{
+	stop();
+}
+
+void RenderGate::stop()
+{
+	if (!threaded)
+		return;
+
+	// Nobody else is around anymore
+	runQueued();
+
+	SdlTexture::setDestroyHook(nullptr);
+	active = nullptr;
+	threaded = false;
+
+	for (auto& entry : retired)
+		SDL_DestroyTexture(entry.texture);
+	retired.clear();
+
+	SDL_DestroyCond(finished);
+	SDL_DestroyMutex(mutex);
+	finished = nullptr;
+	mutex = nullptr;
+}
+
+bool RenderGate::isThreaded() const
+{
+	return threaded;
+}
+
+bool RenderGate::isRenderThread() const
+{
+	return !threaded || SDL_ThreadID() == ownerThread;
+}
+
+void RenderGate::invoke(const std::function<void()>& job)
+{
+	if (!job)
+		return;
+
+	if (isRenderThread())
+	{
+		job();
+		return;
+	}
+
+	Job request{ &job, false };
+
+	SDL_LockMutex(mutex);
+	queued.push_back(&request);
+	while (!request.done)
+		SDL_CondWait(finished, mutex);
+	SDL_UnlockMutex(mutex);
+}
+
+void RenderGate::serve(PassKey<Engine> pk)
+{
+	runQueued();
+}
+
+void RenderGate::runQueued()
+{
+	if (!threaded)
+		return;
+
+	SDL_LockMutex(mutex);
+	if (queued.empty())
+	{
+		SDL_UnlockMutex(mutex);
+		return;
+	}
+	std::vector<Job*> jobs;
+	jobs.swap(queued);
+	SDL_UnlockMutex(mutex);
+
+	// Run outside the lock so jobs may retire textures
+	for (auto job : jobs)
+		(*job->work)();
+
+	SDL_LockMutex(mutex);
+	for (auto job : jobs)
+		job->done = true;
+	SDL_CondBroadcast(finished);
+	SDL_UnlockMutex(mutex);
+}
+
+void RenderGate::markPublished(PassKey<Engine> pk, uint32_t sequence)
+{
+	if (!threaded)
+		return;
+
+	SDL_LockMutex(mutex);
+	lastPublished = sequence;
+	SDL_UnlockMutex(mutex);
+}
+
+void RenderGate::collectRetired(PassKey<Engine> pk, uint32_t replayingSequence)
+{
+	if (!threaded)
+		return;
+
+	SDL_LockMutex(mutex);
+	size_t kept = 0;
+	for (size_t i = 0; i < retired.size(); i++)
+	{
+		// Packets up to retiredAfter may still draw it
+		if (retired[i].retiredAfter < replayingSequence)
+			SDL_DestroyTexture(retired[i].texture);
+		else
+			retired[kept++] = retired[i];
+	}
+	retired.resize(kept);
+	SDL_UnlockMutex(mutex);
+}
+
+void RenderGate::retireTexture(SDL_Texture* texture)
+{
+	RenderGate* gate = active;
+	if (!gate || !gate->threaded)
+	{
+		SDL_DestroyTexture(texture);
+		return;
+	}
+
+	SDL_LockMutex(gate->mutex);
+	gate->retired.push_back(RetiredTexture{ texture, gate->lastPublished });
+	SDL_UnlockMutex(gate->mutex);
+}
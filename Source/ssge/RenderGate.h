@@ -0,0 +1,82 @@
+#pragma once
+#include <SDL.h>
+#include <functional>
+#include <vector>
+#include <cstdint>
+#include "PassKey.h"
+
+namespace ssge
+{
+	class Engine;
+
+	// Keeps SDL_Renderer and window work on the thread that owns them
+	// while the simulation runs on its own thread.
+	//
+	// - invoke() runs a job on the render thread and waits for it
+	//   (texture loading, window mode changes).
+	// - Textures freed by the simulation are retired instead of destroyed,
+	//   because packets still in flight may reference them. They get
+	//   destroyed once the render thread has moved past those packets.
+	//
+	// While threading is off, everything runs immediately on the caller.
+	class RenderGate
+	{
+		struct Job
+		{
+			const std::function<void()>* work;
+			bool done;
+		};
+
+		struct RetiredTexture
+		{
+			SDL_Texture* texture;
+			uint32_t retiredAfter; // Last packet that may reference it
+		};
+
+		// Gate that SdlTexture's destroy hook reports to
+		static RenderGate* active;
+
+		bool threaded = false;
+		SDL_threadID ownerThread = 0;
+
+		SDL_mutex* mutex = nullptr;
+		SDL_cond* finished = nullptr;
+		std::vector<Job*> queued;
+		std::vector<RetiredTexture> retired;
+		uint32_t lastPublished = 0;
+
+		static void retireTexture(SDL_Texture* texture);
+		void runQueued();
+		void stop();
+
+	public:
+		RenderGate(PassKey<Engine> pk);
+		RenderGate(const RenderGate& toCopy) = delete;
+		RenderGate(RenderGate&& toMove) = delete;
+		~RenderGate();
+
+		// Starts gating. Call on the render thread before starting the
+		// simulation thread.
+		bool begin(PassKey<Engine> pk);
+		// Stops gating and destroys all retired textures.
+		// Call on the render thread after the simulation thread is gone.
+		void end(PassKey<Engine> pk);
+
+		bool isThreaded() const;
+		bool isRenderThread() const;
+
+		// Runs the job on the render thread and returns when it's done.
+		// Runs it right away if we're already there or not threaded.
+		void invoke(const std::function<void()>& job);
+
+		// Render thread: runs all queued jobs
+		void serve(PassKey<Engine> pk);
+
+		// Simulation thread: a packet with this sequence was published
+		void markPublished(PassKey<Engine> pk, uint32_t sequence);
+
+		// Render thread: about to replay this packet, so everything retired
+		// before it was published can go now
+		void collectRetired(PassKey<Engine> pk, uint32_t replayingSequence);
+	};
+}
@@ -1,5 +1,5 @@
 #pragma once
-#include <string>
+#include "ClassID.h"
 
 namespace ssge
 {
@@ -10,7 +10,7 @@ namespace ssge
 	{
 	public:
 		Scene() = default;
-		virtual std::string getSceneClassID() const = 0;
+		virtual ClassID getSceneClassID() const = 0;
 		virtual void init(SceneStepContext& context) = 0;
 		virtual void step(SceneStepContext& context) = 0;
 		virtual void draw(DrawContext& context) = 0;
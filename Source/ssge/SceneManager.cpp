@@ -5,11 +5,14 @@
 #include "StepContext.h"
 #include "DrawContext.h"
 #include "Accessor.h"
+#include "Profiler.h"
 
 using namespace ssge;
 
 void SceneManager::step(StepContext& context)
 {
+	SSGE_PROFILE_ZONE("SceneManager::step");
+
 	paused = wannaPause;
 
 	if (auto scene = getCurrentScene())
@@ -26,9 +29,13 @@ void SceneManager::step(StepContext& context)
 				context.inputs.accessDowngrade(),
 				context.drawing,
 				context.menus,
-				CurrentSceneAccess(scene)
+				CurrentSceneAccess(scene),
+				context.events
 			);
-			scene->init(sceneStepContext);
+			{
+				SSGE_PROFILE_ZONE("Scene::init");
+				scene->init(sceneStepContext);
+			}
 			sceneInitialized = true;
 		}
 		if (!isPaused() && !queuedScene)
@@ -43,9 +50,15 @@ void SceneManager::step(StepContext& context)
 				context.inputs.accessDowngrade(),
 				context.drawing,
 				context.menus,
-				CurrentSceneAccess(scene)
+				CurrentSceneAccess(scene),
+				context.events
 			);
 			scene->step(sceneStepContext);
+			steppedLastTick = true;
+		}
+		else
+		{
+			steppedLastTick = false;
 		}
 	}
 
@@ -81,8 +94,10 @@ void SceneManager::step(StepContext& context)
 			currentScene = std::move(queuedScene);
 			queuedScene = nullptr;
 			sceneInitialized = false;
+			steppedLastTick = false;
 			paused = false; // New scenes shouldn't start paused!
 			wannaPause = false;
+			context.events.post(SceneChangedEvent{});
 		}
 	}
 	else if (fadeVal > 0)
@@ -96,23 +111,22 @@ void SceneManager::draw(DrawContext& context) const
 	// Draw current scene
 	if (auto scene = getCurrentScene())
 	{
-		scene->draw(context);
+		if (steppedLastTick)
+		{
+			scene->draw(context);
+		}
+		else
+		{ // Frozen scene (paused etc.) has nothing to blend between
+			DrawContext frozenContext = context.deriveWithInterpolation(1.0f);
+			scene->draw(frozenContext);
+		}
 	}
 
-	SDL_Renderer* renderer = context.getRenderer();
 	SDL_Color backgroundColor{ 0,0,0,fadeVal };
 
 	// Draw background color
-	SDL_SetRenderDrawColor(
-		renderer,
-		backgroundColor.r,
-		backgroundColor.g,
-		backgroundColor.b,
-		backgroundColor.a
-	);
-
 	SDL_Rect bounds = context.getBounds();
-	SDL_RenderFillRect(renderer, &bounds);
+	context.fillRect(bounds, backgroundColor);
 }
 
 void SceneManager::wrapUp()
@@ -125,11 +139,11 @@ Scene* SceneManager::getCurrentScene() const
 	return currentScene.get();
 }
 
-std::string SceneManager::getCurrentSceneClassID() const
+ClassID SceneManager::getCurrentSceneClassID() const
 {
 	if (!currentScene)
 	{
-		return "";
+		return ClassID();
 	}
 	else return currentScene->getSceneClassID();
 }
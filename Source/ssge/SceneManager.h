@@ -18,6 +18,9 @@ namespace ssge
 		bool paused = false;
 		bool wannaPause = false;
 		bool sceneInitialized = false;
+		// Whether the current scene got stepped during the last tick.
+		// If not, drawing doesn't interpolate between ticks.
+		bool steppedLastTick = false;
 		std::unique_ptr<Scene> queuedScene;
 		uint8_t fadeVal = 0;
 		bool wannaWrapUp = false;
@@ -32,7 +35,7 @@ namespace ssge
 		void wrapUp();
 
 		Scene* getCurrentScene() const;
-		std::string getCurrentSceneClassID() const;
+		ClassID getCurrentSceneClassID() const;
 		Scene* changeScene(std::unique_ptr<Scene> newScene);
 		bool isSceneInitialized() const;
 		bool isPaused() const;
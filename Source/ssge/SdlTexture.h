@@ -14,19 +14,18 @@ public:
     explicit SdlTexture(SDL_Texture* tex) noexcept : texture(tex) {}
 
     // Constructor from file path and renderer
-    SdlTexture(const std::string& path, SDL_Renderer* renderer) noexcept : texture(nullptr)
+    SdlTexture(const std::string& path, SDL_Renderer* renderer) noexcept
+        : SdlTexture(loadSurface(path), renderer) {}
+
+    // Constructor from a decoded image (see loadSurface). Frees the surface.
+    SdlTexture(SDL_Surface* loadedSurface, SDL_Renderer* renderer) noexcept : texture(nullptr)
     {
-        SDL_Surface* loadedSurface = IMG_Load(path.c_str());
-        if (!loadedSurface)
-        {
-            std::cout << "Unable to load image %s! SDL_image Error: %s\n" << path.c_str() << IMG_GetError();
-        }
-        else
+        if (loadedSurface)
         {
             texture = SDL_CreateTextureFromSurface(renderer, loadedSurface);
             if (!texture)
             {
-                std::cout << "Unable to create texture from %s! SDL Error: %s\n" << path.c_str() << SDL_GetError();
+                std::cout << "Unable to create texture! SDL Error: " << SDL_GetError() << std::endl;
             }
             else
             {
@@ -36,6 +35,18 @@ public:
         }
     }
 
+    // Decodes an image file, nullptr if it can't. Needs no renderer, so
+    // it can run on any thread (e.g. a JobPool task).
+    static SDL_Surface* loadSurface(const std::string& path) noexcept
+    {
+        SDL_Surface* loadedSurface = IMG_Load(path.c_str());
+        if (!loadedSurface)
+        {
+            std::cout << "Unable to load image %s! SDL_image Error: %s\n" << path.c_str() << IMG_GetError();
+        }
+        return loadedSurface;
+    }
+
     // Assignment operator from SDL_Texture* (lazy initialization/ownership transfer)
     SdlTexture& operator=(SDL_Texture* tex) noexcept {
         if (texture != tex) {
@@ -77,11 +88,19 @@ public:
     // Releases the texture manually (optional)
     void free() noexcept {
         if (texture) {
-            SDL_DestroyTexture(texture);
+            if (auto hook = destroyHook())
+                hook(texture);
+            else
+                SDL_DestroyTexture(texture);
             texture = nullptr;
         }
     }
 
+    // Lets someone else take over destroying textures (e.g. defer it until
+    // the render thread is done with them). nullptr destroys right away.
+    using DestroyHook = void(*)(SDL_Texture*);
+    static void setDestroyHook(DestroyHook hook) noexcept { destroyHook() = hook; }
+
     // Release ownership of the texture without destroying it
     SDL_Texture* release() noexcept {
         SDL_Texture* tmp = texture;
@@ -141,4 +160,9 @@ public:
 
 private:
     SDL_Texture* texture;
+
+    static DestroyHook& destroyHook() noexcept {
+        static DestroyHook hook = nullptr;
+        return hook;
+    }
 };
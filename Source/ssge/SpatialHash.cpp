@@ -0,0 +1,241 @@
+#include "SpatialHash.h"
+#include <cmath>
+
+using namespace ssge;
+
+namespace
+{
+	bool overlaps(const SDL_FRect& a, const SDL_FRect& b)
+	{
+		return a.x < b.x + b.w && b.x < a.x + a.w &&
+			a.y < b.y + b.h && b.y < a.y + a.h;
+	}
+
+	// Distance from the point to the nearest point of the box, squared
+	float distanceSquared(SDL_FPoint point, const SDL_FRect& box)
+	{
+		float dx = 0.f;
+		if (point.x < box.x) dx = box.x - point.x;
+		else if (point.x > box.x + box.w) dx = point.x - (box.x + box.w);
+
+		float dy = 0.f;
+		if (point.y < box.y) dy = box.y - point.y;
+		else if (point.y > box.y + box.h) dy = point.y - (box.y + box.h);
+
+		return dx * dx + dy * dy;
+	}
+}
+
+SpatialHash::SpatialHash()
+{
+	buckets.resize(MIN_BUCKETS);
+}
+
+SpatialHash::Span SpatialHash::spanOf(const SDL_FRect& box) const
+{
+	Span span;
+	span.col0 = (int)std::floor(box.x / cellWidth);
+	span.row0 = (int)std::floor(box.y / cellHeight);
+	span.col1 = (int)std::floor((box.x + box.w) / cellWidth);
+	span.row1 = (int)std::floor((box.y + box.h) / cellHeight);
+	return span;
+}
+
+std::vector<uint32_t>& SpatialHash::bucketOf(int col, int row)
+{
+	uint32_t hash = (uint32_t)col * 73856093u ^ (uint32_t)row * 19349663u;
+	return buckets[hash & (uint32_t)(buckets.size() - 1)];
+}
+
+void SpatialHash::link(uint32_t id, const Span& span)
+{
+	for (int row = span.row0; row <= span.row1; row++)
+		for (int col = span.col0; col <= span.col1; col++)
+			bucketOf(col, row).push_back(id);
+}
+
+void SpatialHash::unlink(uint32_t id, const Span& span)
+{
+	for (int row = span.row0; row <= span.row1; row++)
+	{
+		for (int col = span.col0; col <= span.col1; col++)
+		{
+			// Order within a bucket doesn't matter, swap out
+			auto& bucket = bucketOf(col, row);
+			for (size_t i = 0; i < bucket.size(); i++)
+			{
+				if (bucket[i] == id)
+				{
+					bucket[i] = bucket.back();
+					bucket.pop_back();
+					break;
+				}
+			}
+		}
+	}
+}
+
+uint32_t SpatialHash::nextStamp()
+{
+	if (++stamp == 0)
+	{ // Wrapped around, forget old stamps
+		for (auto& record : records)
+			record.stamp = 0;
+		stamp = 1;
+	}
+	return stamp;
+}
+
+void SpatialHash::rebuild(size_t bucketCount)
+{
+	for (auto& bucket : buckets)
+		bucket.clear();
+	if (bucketCount != buckets.size())
+		buckets.resize(bucketCount);
+
+	for (uint32_t id = 0; id < records.size(); id++)
+	{
+		Record& record = records[id];
+		if (!record.present)
+			continue;
+		record.span = spanOf(record.box);
+		link(id, record.span);
+	}
+}
+
+void SpatialHash::setCellSize(float width, float height)
+{
+	cellWidth = width > 0.f ? width : 1.f;
+	cellHeight = height > 0.f ? height : 1.f;
+	rebuild(buckets.size());
+}
+
+void SpatialHash::reserve(size_t count)
+{
+	if (records.size() < count)
+		records.resize(count);
+
+	// Around two buckets per box keeps them short
+	size_t bucketCount = buckets.size();
+	while (bucketCount < count * 2)
+		bucketCount *= 2;
+	if (bucketCount != buckets.size())
+		rebuild(bucketCount);
+}
+
+void SpatialHash::update(uint32_t id, const SDL_FRect& box)
+{
+	if (id >= records.size())
+		records.resize(id + 1);
+
+	Record& record = records[id];
+	Span span = spanOf(box);
+	record.box = box;
+
+	if (record.present && record.span == span)
+		return; // Same cells, nothing to move
+
+	if (record.present)
+		unlink(id, record.span);
+	link(id, span);
+	record.span = span;
+	record.present = true;
+}
+
+void SpatialHash::remove(uint32_t id)
+{
+	if (!contains(id))
+		return;
+
+	Record& record = records[id];
+	unlink(id, record.span);
+	record.present = false;
+}
+
+void SpatialHash::clear()
+{
+	for (auto& bucket : buckets)
+		bucket.clear();
+	for (auto& record : records)
+		record.present = false;
+}
+
+void SpatialHash::queryRect(const SDL_FRect& rect, std::vector<uint32_t>& results)
+{
+	uint32_t current = nextStamp();
+	Span span = spanOf(rect);
+
+	for (int row = span.row0; row <= span.row1; row++)
+	{
+		for (int col = span.col0; col <= span.col1; col++)
+		{
+			for (uint32_t id : bucketOf(col, row))
+			{
+				Record& record = records[id];
+				if (record.stamp == current)
+					continue;
+				record.stamp = current;
+				if (overlaps(record.box, rect))
+					results.push_back(id);
+			}
+		}
+	}
+}
+
+void SpatialHash::queryRadius(SDL_FPoint center, float radius, std::vector<uint32_t>& results)
+{
+	if (radius < 0.f)
+		return;
+
+	uint32_t current = nextStamp();
+	Span span = spanOf(SDL_FRect{ center.x - radius, center.y - radius, radius * 2.f, radius * 2.f });
+	float radiusSquared = radius * radius;
+
+	for (int row = span.row0; row <= span.row1; row++)
+	{
+		for (int col = span.col0; col <= span.col1; col++)
+		{
+			for (uint32_t id : bucketOf(col, row))
+			{
+				Record& record = records[id];
+				if (record.stamp == current)
+					continue;
+				record.stamp = current;
+				if (distanceSquared(center, record.box) <= radiusSquared)
+					results.push_back(id);
+			}
+		}
+	}
+}
+
+void SpatialHash::queryPairs(std::vector<std::pair<uint32_t, uint32_t>>& results)
+{
+	// Each box against what shares its buckets, keeping only higher ids
+	// so every pair comes out once
+	for (uint32_t first = 0; first < records.size(); first++)
+	{
+		const Record& record = records[first];
+		if (!record.present)
+			continue;
+
+		uint32_t current = nextStamp();
+		const Span& span = record.span;
+		for (int row = span.row0; row <= span.row1; row++)
+		{
+			for (int col = span.col0; col <= span.col1; col++)
+			{
+				for (uint32_t second : bucketOf(col, row))
+				{
+					if (second <= first)
+						continue;
+					Record& other = records[second];
+					if (other.stamp == current)
+						continue;
+					other.stamp = current;
+					if (overlaps(record.box, other.box))
+						results.emplace_back(first, second);
+				}
+			}
+		}
+	}
+}
@@ -0,0 +1,84 @@
+#pragma once
+#include "SDL.h"
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace ssge
+{
+	// Uniform grid of cells, hashed into a fixed number of buckets, for
+	// finding boxes near a rect, a point or each other.
+	//
+	// Boxes are keyed by small dense ids (EntityManager uses slot indices).
+	// update() only touches buckets when a box moves into different cells,
+	// so keeping it current every tick is cheap. Buckets and the per-id
+	// records keep their capacity, so once warmed up (or reserved) neither
+	// updating nor querying allocates.
+	//
+	// Cells that hash to the same bucket share it, and a box spanning
+	// several cells is in several buckets. Queries test the stored boxes
+	// themselves and report every id once.
+	class SpatialHash
+	{
+		struct Span
+		{
+			int col0 = 0, row0 = 0, col1 = -1, row1 = -1;
+
+			bool operator==(const Span& other) const {
+				return col0 == other.col0 && row0 == other.row0 &&
+					col1 == other.col1 && row1 == other.row1;
+			}
+			bool operator!=(const Span& other) const { return !(*this == other); }
+		};
+
+		struct Record
+		{
+			SDL_FRect box{ 0.f, 0.f, 0.f, 0.f };
+			Span span;
+			bool present = false;
+			uint32_t stamp = 0; // Last query that reported this id
+		};
+
+		static const size_t MIN_BUCKETS = 256;
+
+		float cellWidth = 64.f;
+		float cellHeight = 64.f;
+		std::vector<std::vector<uint32_t>> buckets; // Power of two
+		std::vector<Record> records;                // By id
+		uint32_t stamp = 0;
+
+		Span spanOf(const SDL_FRect& box) const;
+		std::vector<uint32_t>& bucketOf(int col, int row);
+		void link(uint32_t id, const Span& span);
+		void unlink(uint32_t id, const Span& span);
+		uint32_t nextStamp();
+		void rebuild(size_t bucketCount);
+
+	public:
+		SpatialHash();
+
+		// Sets the cell size (the level's block size) and re-files every box
+		void setCellSize(float width, float height);
+
+		// Makes room for ids up to count without allocating
+		void reserve(size_t count);
+
+		// Files id under box, or moves it there
+		void update(uint32_t id, const SDL_FRect& box);
+		void remove(uint32_t id);
+		void clear();
+
+		bool contains(uint32_t id) const { return id < records.size() && records[id].present; }
+
+		// Queries append to results, which is not cleared first.
+
+		// Ids whose box overlaps rect
+		void queryRect(const SDL_FRect& rect, std::vector<uint32_t>& results);
+
+		// Ids whose box is within radius of center
+		void queryRadius(SDL_FPoint center, float radius, std::vector<uint32_t>& results);
+
+		// Every pair of ids whose boxes overlap, lower id first, each once
+		void queryPairs(std::vector<std::pair<uint32_t, uint32_t>>& results);
+	};
+}
@@ -1,5 +1,7 @@
 #include "Sprite.h"
+#include <algorithm>
 #include <cmath>
+#include <cstdlib>
 
 using namespace ssge;
 
@@ -230,19 +232,32 @@ SDL_Rect Sprite::getBounds() const
 {
 	int imgIdx = calculateImageIndex();
 	if (imgIdx == -1)
-		return SDL_Rect{ 0,0 };
+		return SDL_Rect{ 0,0,0,0 };
 
 	const auto& img = definition.images[imgIdx];
 
-	SDL_Point offset = img.anchor;
-	offset.x *= -1;
-	offset.y *= -1;
+	// Same placement as render(), relative to the anchor
+	int absW = static_cast<int>(img.region.w * std::fabs(xscale));
+	int absH = static_cast<int>(img.region.h * std::fabs(yscale));
+	int scaledAnchorX = static_cast<int>(img.anchor.x * std::fabs(xscale));
+	int scaledAnchorY = static_cast<int>(img.anchor.y * std::fabs(yscale));
+
+	SDL_Rect bounds{
+		(xscale < 0) ? -(absW - scaledAnchorX) : -scaledAnchorX,
+		(yscale < 0) ? -(absH - scaledAnchorY) : -scaledAnchorY,
+		absW,
+		absH
+	};
 
-	SDL_Rect offseted = img.region;
-	offseted.x += offset.x;
-	offseted.y += offset.y;
+	if (angle % 360 != 0)
+	{ // Rotated around the anchor, anything within the farthest corner
+		int farX = std::max(std::abs(bounds.x), std::abs(bounds.x + bounds.w));
+		int farY = std::max(std::abs(bounds.y), std::abs(bounds.y + bounds.h));
+		int radius = static_cast<int>(std::ceil(std::sqrt(float(farX * farX + farY * farY))));
+		bounds = SDL_Rect{ -radius, -radius, radius * 2, radius * 2 };
+	}
 
-	return offseted;
+	return bounds;
 }
 
 //=============================
@@ -329,10 +344,10 @@ void Sprite::update(double deltaTime)
 
 void Sprite::draw(DrawContext context) const
 {
-	render(context.getRenderer(), context.calculateAnchorPoint());
+	render(context, context.calculateAnchorPoint());
 }
 
-void Sprite::render(SDL_Renderer* renderer, SDL_Point offsetFromViewport) const
+void Sprite::render(const DrawContext& context, SDL_Point offsetFromViewport) const
 {
 	int imgIndex = calculateImageIndex();
 	if (imgIndex == -1)
@@ -380,16 +395,10 @@ void Sprite::render(SDL_Renderer* renderer, SDL_Point offsetFromViewport) const
 		(yscale < 0) ? (absH - scaledAnchorY) : scaledAnchorY // center.y
 	};
 
-	// Update TextureAlphaMod, but only if we changed it
-	Uint8 alphaInSDL;
-	auto& spritesheet = definition.spritesheet;
-	SDL_GetTextureAlphaMod(spritesheet, &alphaInSDL);
-	if(alpha!=alphaInSDL)
-		SDL_SetTextureAlphaMod(spritesheet, alpha);
-
-	SDL_RenderCopyEx(
-		renderer, spritesheet, &src, &dst, static_cast<double>(angle),
-		&center, flip);
+	// TextureAlphaMod gets updated on the way, but only if we changed it
+	context.copyEx(
+		definition.spritesheet, &src, &dst, static_cast<double>(angle),
+		&center, flip, alpha);
 
 	// Redundant
 	//SDL_SetTextureAlphaMod(definition.spritesheet, 255);
@@ -4,10 +4,11 @@
 #include <vector>
 #include <memory>
 #include "DrawContext.h"
+#include "ObjectPool.h"
 
 namespace ssge
 {
-	class Sprite
+	class Sprite : public Pooled<Sprite>
 	{
 	public:
 		class Image // An image is just a to-be-cropped part of the spritesheet texture
@@ -119,6 +120,9 @@ namespace ssge
 		Sprite& setLerp(int lerp);
 		Sprite& resetSpeed();
 
+		// Where the current image lands relative to the anchor (the
+		// entity's position), scaled and flipped. Rotated sprites get a
+		// square that covers every angle.
 		SDL_Rect getBounds() const;
 
 		// CLARIFICATIONS: This is how rendering a Sprite works
@@ -139,7 +143,7 @@ namespace ssge
 		//TODO: New step context???
 		void update(double deltaTime);
 		void draw(DrawContext context) const;
-		void render(SDL_Renderer* renderer, SDL_Point offsetFromViewport) const;
+		void render(const DrawContext& context, SDL_Point offsetFromViewport) const;
 
 		Sprite::Animation animation;
 		const Sprite::Definition& definition;
@@ -16,7 +16,8 @@ StepContext::StepContext(
     ScenesAccess scenes_,
     InputsAccessConfigurable inputs_,
     DrawingAccess drawing_,
-    MenusAccess menus_
+    MenusAccess menus_,
+    EventsAccess events_
 )
     : StepContextBase(deltaTime),
     engine(std::move(engine_)),
@@ -26,7 +27,8 @@ StepContext::StepContext(
     scenes(std::move(scenes_)),
     inputs(std::move(inputs_)),
     drawing(std::move(drawing_)),
-    menus(std::move(menus_))
+    menus(std::move(menus_)),
+    events(std::move(events_))
 {
 }
 
@@ -41,7 +43,8 @@ SceneStepContext::SceneStepContext(
     InputsAccess inputs_,
     DrawingAccess drawing_,
     MenusAccess menus_,
-    CurrentSceneAccess currentScene_
+    CurrentSceneAccess currentScene_,
+    EventsAccess events_
 )
     : StepContextBase(deltaTime),
     engine(std::move(engine_)),
@@ -51,7 +54,8 @@ SceneStepContext::SceneStepContext(
     inputs(std::move(inputs_)),
     drawing(std::move(drawing_)),
     menus(std::move(menus_)),
-    currentScene(std::move(currentScene_))
+    currentScene(std::move(currentScene_)),
+    events(std::move(events_))
 {
 }
 
@@ -66,7 +70,8 @@ GameWorldStepContext::GameWorldStepContext(
     DrawingAccess drawing_,
     CurrentSceneAccess currentScene_,
     GameWorldAccess gameWorld_,
-    LevelAccess level_
+    LevelAccess level_,
+    EventsAccess events_
 )
     : StepContextBase(deltaTime),
     engine(std::move(engine_)),
@@ -76,7 +81,8 @@ GameWorldStepContext::GameWorldStepContext(
     drawing(std::move(drawing_)),
     currentScene(std::move(currentScene_)),
     gameWorld(std::move(gameWorld_)),
-    level(std::move(level_))
+    level(std::move(level_)),
+    events(std::move(events_))
 {
 }
 
@@ -93,7 +99,8 @@ EntityStepContext::EntityStepContext(
     GameWorldAccess gameWorld_,
     LevelAccess level_,
     EntitiesAccessWCurrent entitiesAndCurrent_,
-    SpritesAccess sprites_
+    SpritesAccess sprites_,
+    EventsAccess events_
 )
     : StepContextBase(deltaTime),
     engine(engine_.restrainAccess()),
@@ -105,6 +112,12 @@ EntityStepContext::EntityStepContext(
     gameWorld(std::move(gameWorld_)),
     level(std::move(level_)),
     entities(std::move(entitiesAndCurrent_)),
-    sprites(std::move(sprites_))
+    sprites(std::move(sprites_)),
+    events(std::move(events_))
+{
+}
+
+void EntityStepContext::rebind(PassKey<EntityManager> pk, Entity* current)
 {
+    entities.rebind(pk, current);
 }
@@ -36,6 +36,7 @@ namespace ssge {
         InputsAccessConfigurable inputs;
         DrawingAccess drawing;
         MenusAccess menus;
+        EventsAccess events;
 
         explicit StepContext(
             PassKey<Engine> pk,
@@ -47,7 +48,8 @@ namespace ssge {
             ScenesAccess scenes,
             InputsAccessConfigurable inputs,
             DrawingAccess drawing,
-            MenusAccess menus
+            MenusAccess menus,
+            EventsAccess events
         );
     };
 
@@ -62,6 +64,7 @@ namespace ssge {
         DrawingAccess drawing;
         MenusAccess menus;
         CurrentSceneAccess currentScene;
+        EventsAccess events;
 
         explicit SceneStepContext(
             PassKey<SceneManager> pk,
@@ -73,7 +76,8 @@ namespace ssge {
             InputsAccess inputs,
             DrawingAccess drawing,
             MenusAccess menus,
-            CurrentSceneAccess currentScene
+            CurrentSceneAccess currentScene,
+            EventsAccess events
         );
     };
 
@@ -88,6 +92,7 @@ namespace ssge {
         CurrentSceneAccess currentScene;
         GameWorldAccess gameWorld;
         LevelAccess level;
+        EventsAccess events;
 
         explicit GameWorldStepContext(
             PassKey<GameWorld> pk,
@@ -99,7 +104,8 @@ namespace ssge {
             DrawingAccess drawing,
             CurrentSceneAccess currentScene,
             GameWorldAccess gameWorld,
-            LevelAccess level
+            LevelAccess level,
+            EventsAccess events
         );
     };
 
@@ -117,6 +123,7 @@ namespace ssge {
         LevelAccess level;
         EntitiesAccessWCurrent entities;
         SpritesAccess sprites;
+        EventsAccess events;
 
         explicit EntityStepContext(
             PassKey<EntityManager> pk,
@@ -130,8 +137,13 @@ namespace ssge {
             GameWorldAccess gameWorld,
             LevelAccess level,
             EntitiesAccessWCurrent entitiesAndCurrent,
-            SpritesAccess sprites
+            SpritesAccess sprites,
+            EventsAccess events
         );
+
+        // Points the context at the next entity to step.
+        // Everything else stays valid for the whole tick.
+        void rebind(PassKey<EntityManager> pk, Entity* current);
     };
 
 } // namespace ssge
@@ -3,6 +3,11 @@
 #include <cmath>
 #include <string>
 #include <cctype>
+#include <cstddef>
+#include <cstdint>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
 
 namespace ssge
 {
@@ -42,6 +47,70 @@ namespace ssge
 		return s;
 	}
 
+	// FNV-1a over simulation state, for checking that two runs (serial
+	// and parallel, two builds, a replay) ended up in the same place.
+	// Feed scalars only: struct padding would make it unstable.
+	class StateHash
+	{
+		uint64_t value = 14695981039346656037ull;
+	public:
+		void addBytes(const void* data, size_t size)
+		{
+			const unsigned char* bytes = static_cast<const unsigned char*>(data);
+			for (size_t i = 0; i < size; i++)
+			{
+				value ^= bytes[i];
+				value *= 1099511628211ull;
+			}
+		}
+
+		template<typename T>
+		void add(const T& scalar)
+		{
+			static_assert(std::is_arithmetic<T>::value || std::is_enum<T>::value,
+				"StateHash takes scalars");
+			addBytes(&scalar, sizeof(scalar));
+		}
+
+		uint64_t get() const { return value; }
+	};
+
+	// Index of the lowest set bit. bits must not be 0.
+	static inline int lowestBit(uint64_t bits)
+	{
+#if defined(__GNUC__)
+		return __builtin_ctzll(bits);
+#elif defined(_MSC_VER)
+		unsigned long index;
+		if (_BitScanForward(&index, (unsigned long)bits))
+			return (int)index;
+		_BitScanForward(&index, (unsigned long)(bits >> 32));
+		return (int)index + 32;
+#else
+		int index = 0;
+		while (!(bits & 1u)) { bits >>= 1; index++; }
+		return index;
+#endif
+	}
+
+	// Index of the highest set bit. bits must not be 0.
+	static inline int highestBit(uint64_t bits)
+	{
+#if defined(__GNUC__)
+		return 63 - __builtin_clzll(bits);
+#elif defined(_MSC_VER)
+		unsigned long index;
+		if (_BitScanReverse(&index, (unsigned long)(bits >> 32)))
+			return (int)index + 32;
+		_BitScanReverse(&index, (unsigned long)bits);
+		return (int)index;
+#else
+		int index = 63;
+		while (!(bits >> 63)) { bits <<= 1; index--; }
+		return index;
+#endif
+	}
+
 	static inline std::string lower(std::string s)
 	{
 		for (size_t i = 0; i < s.size(); i++)
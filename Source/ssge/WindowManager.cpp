@@ -17,7 +17,8 @@ WindowManager::~WindowManager()
     shutdown();
 }
 
-const char* WindowManager::init(const char* title, int width, int height)
+const char* WindowManager::init(const char* title, int width, int height,
+    bool headless, bool vsync)
 {
     // Don't re-create the window!
     if (window)
@@ -31,7 +32,8 @@ const char* WindowManager::init(const char* title, int width, int height)
         title,
         SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED,
         width, height,
-        SDL_WINDOW_OPENGL | SDL_WINDOW_SHOWN | SDL_WINDOW_RESIZABLE
+        headless ? SDL_WINDOW_HIDDEN
+            : SDL_WINDOW_OPENGL | SDL_WINDOW_SHOWN | SDL_WINDOW_RESIZABLE
     );
 
     // See if window was created
@@ -55,7 +57,13 @@ const char* WindowManager::init(const char* title, int width, int height)
 #endif
 
     // Create renderer for the window
-    renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC);
+    // Headless has no GPU and must never wait for a vblank
+    Uint32 rendererFlags = headless
+        ? SDL_RENDERER_SOFTWARE
+        : SDL_RENDERER_ACCELERATED;
+    if (vsync && !headless)
+        rendererFlags |= SDL_RENDERER_PRESENTVSYNC;
+    renderer = SDL_CreateRenderer(window, -1, rendererFlags);
 
     if (!renderer)
     {
@@ -72,6 +80,8 @@ const char* WindowManager::init(const char* title, int width, int height)
     // Debug the renderer
     SDL_RendererInfo info{};
     SDL_GetRendererInfo(renderer, &info);
+    // Drivers may refuse vsync, the frame pacer needs to know
+    this->vsync = (info.flags & SDL_RENDERER_PRESENTVSYNC) != 0;
     std::cout << "Renderer: " << (info.name ? info.name : "unknown")
         << " | flags: 0x" << std::hex << info.flags << std::dec << "\n";
 
@@ -105,6 +115,11 @@ int ssge::WindowManager::getVirtualHeight() const
     return virtualHeight;
 }
 
+bool ssge::WindowManager::hasVsync() const
+{
+    return vsync;
+}
+
 bool ssge::WindowManager::isUpscaleIntegral() const
 {
     return integralUpscale;
@@ -15,6 +15,7 @@ namespace ssge
 		int virtualHeight = 0;
 		bool integralUpscale = false;
 		bool borderedFullScreen = false;
+		bool vsync = false;
 	public:
 		WindowManager(PassKey<Engine> pk);
 		WindowManager(const WindowManager& toCopy) = delete;
@@ -22,8 +23,10 @@ namespace ssge
 		~WindowManager();
 
 		// Initializes the program window with title and size.
+		// Headless makes a hidden window with a software renderer, no vsync.
 		// Returns error string or nullptr if no error.
-		const char* init(const char* title, int width, int height);
+		const char* init(const char* title, int width, int height,
+			bool headless = false, bool vsync = true);
 		// Gets the window
 		SDL_Window* getWindow() const;
 		// Gets the window surface
@@ -34,6 +37,8 @@ namespace ssge
 		int getVirtualWidth() const;
 		// Gets virtual height
 		int getVirtualHeight() const;
+		// Returns true if the renderer actually waits for vblank
+		bool hasVsync() const;
 		// Returns true if upscale is integral, false if fractional
 		bool isUpscaleIntegral() const;
 		// Sets integral upscale, providing false sets fractional upscale